@@ -0,0 +1,240 @@
+#include "analysis_server.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "game_record.h"
+#include "position_analysis.h"
+
+namespace {
+
+#ifdef _WIN32
+using Socket = SOCKET;
+using Poll_descriptor = WSAPOLLFD;
+const Socket invalid_socket = INVALID_SOCKET;
+
+int poll_sockets(std::vector<Poll_descriptor>& descriptors) {
+  return WSAPoll(descriptors.data(), static_cast<ULONG>(descriptors.size()),
+                 -1);
+}
+
+void close_socket(Socket socket) { closesocket(socket); }
+#else
+using Socket = int;
+using Poll_descriptor = pollfd;
+const Socket invalid_socket = -1;
+
+int poll_sockets(std::vector<Poll_descriptor>& descriptors) {
+  return poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), -1);
+}
+
+void close_socket(Socket socket) { close(socket); }
+#endif
+
+// The longest search a request may ask for
+const int max_request_milliseconds = 3600000;
+
+// The longest request line; a client sending more without a line break is
+// disconnected
+const std::size_t max_request_length = 1 << 20;
+
+/**
+ * @brief A client connection. The socket is closed when the last reference
+ * is dropped, i.e. after the pending responses have been sent.
+ */
+struct Connection {
+  Socket socket;
+  std::mutex send_mutex;
+  // Received bytes not yet forming a complete line, used by the I/O thread
+  std::string received;
+  // Set once the client has gone, so that its queued searches are skipped
+  std::atomic<bool> is_closed{false};
+
+  explicit Connection(Socket socket) : socket(socket) {}
+  ~Connection() { close_socket(socket); }
+
+  /**
+   * @brief Sends a line, giving up silently if the client has gone.
+   */
+  void send_line(const std::string& line) {
+    const std::string data = line + "\n";
+    std::lock_guard<std::mutex> lock(send_mutex);
+    std::size_t sent_count = 0;
+    while (sent_count < data.size()) {
+      const auto count = send(socket, data.data() + sent_count,
+                              static_cast<int>(data.size() - sent_count), 0);
+      if (count <= 0) return;
+      sent_count += static_cast<std::size_t>(count);
+    }
+  }
+};
+
+}  // namespace
+
+Analysis_server::Analysis_server(int port, unsigned int thread_count)
+    : port(port) {
+  if (port < 1 || port > 65535) {
+    throw std::invalid_argument("The port must be between 1 and 65535.");
+  }
+  pool = std::make_unique<Work_stealing_pool>(thread_count);
+}
+
+void Analysis_server::handle_request(
+    const std::string& request,
+    std::function<void(const std::string&)> respond,
+    std::function<bool()> is_abandoned) {
+  std::istringstream tokens(request);
+  std::string command, id, milliseconds;
+  tokens >> command >> id >> milliseconds;
+  std::string sgf;
+  std::getline(tokens >> std::ws, sgf);
+  if (command != "analyze" || id.empty() || sgf.empty()) {
+    respond(make_analysis_error(
+        id, "Expected: analyze <request id> <milliseconds> <SGF game tree>"));
+    return;
+  }
+  int search_milliseconds = 0;
+  try {
+    search_milliseconds = std::stoi(milliseconds);
+  } catch (const std::exception&) {
+  }
+  if (search_milliseconds < 1 ||
+      search_milliseconds > max_request_milliseconds) {
+    respond(make_analysis_error(
+        id, "The search time must be between 1 and " +
+                std::to_string(max_request_milliseconds) + " milliseconds."));
+    return;
+  }
+  pool->submit([id, sgf, search_milliseconds, respond, is_abandoned]() {
+    if (is_abandoned && is_abandoned()) return;
+    std::string response;
+    try {
+      const Game_record record = Game_record::parse_sgf(sgf);
+      response = analyze_position(
+          id,
+          record.board_at_ply(static_cast<int>(record.get_moves().size())),
+          record.get_player_to_move(),
+          std::chrono::milliseconds(search_milliseconds));
+    } catch (const std::exception& e) {
+      response = make_analysis_error(id, e.what());
+    }
+    respond(response);
+  });
+}
+
+void Analysis_server::run() {
+#ifdef _WIN32
+  WSADATA winsock_data;
+  if (WSAStartup(MAKEWORD(2, 2), &winsock_data) != 0) {
+    throw std::runtime_error("Cannot initialise Winsock.");
+  }
+#else
+  // A client closing its connection must not end the server
+  std::signal(SIGPIPE, SIG_IGN);
+#endif
+  Socket listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener == invalid_socket) {
+    throw std::runtime_error("Cannot create a socket.");
+  }
+  const int reuse_address = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR,
+             reinterpret_cast<const char*>(&reuse_address),
+             sizeof(reuse_address));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<unsigned short>(port));
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(listener, reinterpret_cast<const sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listener, SOMAXCONN) != 0) {
+    close_socket(listener);
+    throw std::runtime_error("Cannot listen on port " + std::to_string(port) +
+                             ".");
+  }
+  std::cout << "Listening on 127.0.0.1:" << port << " with "
+            << pool->get_thread_count() << " search threads." << std::endl;
+
+  std::vector<std::shared_ptr<Connection>> connections;
+  std::vector<Poll_descriptor> descriptors;
+  char buffer[4096];
+  while (true) {
+    descriptors.clear();
+    descriptors.push_back(Poll_descriptor{listener, POLLIN, 0});
+    for (const auto& connection : connections) {
+      descriptors.push_back(Poll_descriptor{connection->socket, POLLIN, 0});
+    }
+    if (poll_sockets(descriptors) < 0) continue;
+
+    // Read the connections that were polled, dropping the closed ones
+    std::vector<std::shared_ptr<Connection>> open_connections;
+    for (std::size_t i = 0; i < connections.size(); ++i) {
+      const std::shared_ptr<Connection>& connection = connections[i];
+      bool is_open = true;
+      if (descriptors[i + 1].revents != 0) {
+        const auto count = recv(connection->socket, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+          is_open = false;
+          connection->is_closed = true;
+        } else {
+          connection->received.append(buffer, static_cast<std::size_t>(count));
+        }
+      }
+      std::size_t line_end;
+      while (is_open &&
+             (line_end = connection->received.find('\n')) !=
+                 std::string::npos) {
+        std::string line = connection->received.substr(0, line_end);
+        connection->received.erase(0, line_end + 1);
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (line == "quit") {
+          is_open = false;
+          break;
+        }
+        handle_request(
+            line,
+            [connection](const std::string& response) {
+              connection->send_line(response);
+            },
+            [connection]() -> bool { return connection->is_closed; });
+      }
+      if (is_open && connection->received.size() > max_request_length) {
+        connection->send_line(make_analysis_error(
+            "", "A request cannot be longer than " +
+                    std::to_string(max_request_length) + " bytes."));
+        is_open = false;
+        connection->is_closed = true;
+      }
+      if (is_open) open_connections.push_back(connection);
+    }
+    connections.swap(open_connections);
+
+    if (descriptors[0].revents & POLLIN) {
+      Socket client = accept(listener, nullptr, nullptr);
+      if (client != invalid_socket) {
+        connections.push_back(std::make_shared<Connection>(client));
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+#ifndef ANALYSIS_SERVER_H
+#define ANALYSIS_SERVER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "work_stealing_pool.h"
+
+/**
+ * @class Analysis_server
+ *
+ * @brief A long-running server that analyses the positions of many games at
+ * once for clients on the local machine.
+ *
+ * Clients connect over TCP to 127.0.0.1 and send one request per line:
+ *
+ *     analyze <request id> <milliseconds> <SGF game tree>
+ *
+ * The position after the last move of the game tree is searched by its own
+ * single-threaded Mcts_agent for the given time, with the player to move
+ * following the last move. Every search runs as a task of one shared
+ * Work_stealing_pool, so the searches of all connections share the cores
+ * without a process or an agent per game. A connection may have any number
+ * of requests in flight, and each is answered as soon as its search ends,
+ * i.e. not necessarily in order, with the JSON line of analyze_position()
+ * carrying the request id. Requests that cannot be served are answered with
+ * `{"id": "<request id>", "error": "<message>"}`. The line `quit` closes the
+ * connection once its pending responses are sent. A client that disconnects
+ * or sends a line of more than 1 MiB is dropped, and its searches that have
+ * not started yet are skipped.
+ *
+ * The connections are served by one thread waiting on all of them with
+ * poll(), so idle games cost no thread. POSIX sockets are used, and Winsock
+ * on Windows.
+ */
+class Analysis_server {
+ public:
+  /**
+   * @brief Constructs a server with its worker pool.
+   *
+   * @param port The TCP port to listen on.
+   * @param thread_count The number of searches run at the same time.
+   * @throws std::invalid_argument if the port or thread_count is invalid.
+   */
+  Analysis_server(int port, unsigned int thread_count);
+
+  /**
+   * @brief Listens for connections and serves their requests until the
+   * process ends.
+   *
+   * @throws std::runtime_error if the server cannot listen on the port.
+   */
+  void run();
+
+  /**
+   * @brief Serves a single request line.
+   *
+   * The search runs on the worker pool, and the response line, without the
+   * line break, is passed to respond from the worker thread.
+   *
+   * @param request The request line.
+   * @param respond The function receiving the response.
+   * @param is_abandoned Called by the worker before the search starts; if it
+   * returns true, the request is dropped without a response. Empty to always
+   * search.
+   */
+  void handle_request(const std::string& request,
+                      std::function<void(const std::string&)> respond,
+                      std::function<bool()> is_abandoned = nullptr);
+
+ private:
+  int port;
+  std::unique_ptr<Work_stealing_pool> pool;
+};
+
+#endif  // ANALYSIS_SERVER_H
@@ -0,0 +1,143 @@
+#include "batch_analysis.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "game_record.h"
+#include "position_analysis.h"
+#include "position_database.h"
+#include "work_stealing_pool.h"
+
+namespace {
+
+// Positions searched or waiting to be written, per thread. The window keeps
+// every worker busy while the writer holds back only a few results.
+const std::size_t positions_in_flight_per_thread = 4;
+
+/**
+ * @brief Infers the player to move from the stones on the board. After a
+ * swap, Red has the only stone and Blue moves, as in a game without one.
+ */
+Cell_state infer_player_to_move(const Board& board) {
+  int blue_count = 0;
+  int red_count = 0;
+  for (int row = 0; row < board.get_board_size(); ++row) {
+    for (int col = 0; col < board.get_board_size(); ++col) {
+      const Cell_state cell = board.get_cell(row, col);
+      blue_count += cell == Cell_state::Blue;
+      red_count += cell == Cell_state::Red;
+    }
+  }
+  return blue_count > red_count ? Cell_state::Red : Cell_state::Blue;
+}
+
+}  // namespace
+
+std::size_t run_batch_analysis(const std::string& input_path,
+                               const std::string& output_path,
+                               std::chrono::milliseconds search_time,
+                               std::size_t max_child_count,
+                               unsigned int thread_count) {
+  // The positions are decoded by the searching threads, from the mapped
+  // database or from the parsed games
+  std::unique_ptr<Position_database> database;
+  std::vector<Game_record> records;
+  std::size_t position_count = 0;
+  std::function<std::pair<Board, Cell_state>(std::size_t)> get_position;
+  if (Position_database::is_database_file(input_path)) {
+    database = std::make_unique<Position_database>(input_path);
+    position_count = database->size();
+    get_position = [&database](std::size_t index) {
+      const Position_view position = (*database)[index];
+      Board board = position.to_board();
+      Cell_state player_to_move = position.get_player_to_move();
+      if (player_to_move == Cell_state::Empty) {
+        player_to_move = infer_player_to_move(board);
+      }
+      return std::make_pair(std::move(board), player_to_move);
+    };
+  } else {
+    std::ifstream input(input_path);
+    if (!input) {
+      throw std::runtime_error("Cannot open " + input_path + ".");
+    }
+    Sgf_reader reader(input);
+    Game_record record(2);
+    while (reader.read_next(record)) {
+      records.push_back(record);
+    }
+    position_count = records.size();
+    get_position = [&records](std::size_t index) {
+      const Game_record& record = records[index];
+      return std::make_pair(
+          record.board_at_ply(static_cast<int>(record.get_moves().size())),
+          record.get_player_to_move());
+    };
+  }
+  std::ofstream output(output_path);
+  if (!output) {
+    throw std::runtime_error("Cannot write " + output_path + ".");
+  }
+
+  // Only a window of positions is in flight at a time, and each position
+  // is submitted once the result of the position one window earlier is
+  // written, so memory stays bounded however large the input is
+  const std::size_t window_size = std::min(
+      position_count,
+      positions_in_flight_per_thread * std::max(thread_count, 1u));
+  std::vector<std::string> results(window_size);
+  std::vector<char> is_analysed(window_size, 0);
+  std::mutex results_mutex;
+  std::condition_variable result_stored;
+  Work_stealing_pool pool(thread_count);
+  const auto submit_position = [&](std::size_t index) {
+    pool.submit([&, index]() {
+      const std::string id = std::to_string(index);
+      std::string result;
+      try {
+        const std::pair<Board, Cell_state> position = get_position(index);
+        result = analyze_position(id, position.first, position.second,
+                                  search_time, max_child_count);
+      } catch (const std::exception& e) {
+        result = make_analysis_error(id, e.what());
+      }
+      {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        results[index % window_size] = std::move(result);
+        is_analysed[index % window_size] = 1;
+      }
+      result_stored.notify_one();
+    });
+  };
+  for (std::size_t index = 0; index < window_size; ++index) {
+    submit_position(index);
+  }
+  // Write the results in input order as soon as they are available
+  for (std::size_t index = 0; index < position_count; ++index) {
+    const std::size_t slot = index % window_size;
+    std::string result;
+    {
+      std::unique_lock<std::mutex> lock(results_mutex);
+      result_stored.wait(lock, [&] { return is_analysed[slot] != 0; });
+      result.swap(results[slot]);
+      is_analysed[slot] = 0;
+    }
+    if (index + window_size < position_count) {
+      submit_position(index + window_size);
+    }
+    output << result << '\n';
+  }
+  output.close();
+  if (!output) {
+    throw std::runtime_error("Cannot write " + output_path + ".");
+  }
+  return position_count;
+}
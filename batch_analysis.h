@@ -0,0 +1,43 @@
+#ifndef BATCH_ANALYSIS_H
+#define BATCH_ANALYSIS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Analyses every position of a file and writes one JSON line per
+ * position, in the order of the input.
+ *
+ * The input is either a Position_database, recognised by its header, or an
+ * SGF collection, of which the position after the last move of each game is
+ * analysed. A position without a known player to move is given to Red if
+ * Blue has more stones and to Blue otherwise.
+ *
+ * Each position is searched by its own single-threaded Mcts_agent with the
+ * same time limit, and the searches run as independent tasks of a
+ * Work_stealing_pool. Parallelising across positions instead of within a
+ * search needs no synchronisation of a shared tree, so it scales with the
+ * number of threads. Each line is the JSON object of analyze_position(),
+ * whose id is the index of the position in the input, or an error object for
+ * a position that cannot be analysed, e.g. a finished game. A line is
+ * written as soon as the positions before it are done, and only a few
+ * positions per thread are in flight, so memory does not grow with the input.
+ *
+ * @param input_path The path of the positions.
+ * @param output_path The path of the JSON lines to write.
+ * @param search_time The time limit of each search.
+ * @param max_child_count The number of moves searched as multi-PV and
+ * reported per position, the best first.
+ * @param thread_count The number of searches run at the same time.
+ * @return The number of positions analysed.
+ * @throws std::runtime_error if a file cannot be read or written.
+ * @throws std::invalid_argument if the SGF collection is malformed.
+ */
+std::size_t run_batch_analysis(const std::string& input_path,
+                               const std::string& output_path,
+                               std::chrono::milliseconds search_time,
+                               std::size_t max_child_count,
+                               unsigned int thread_count);
+
+#endif  // BATCH_ANALYSIS_H
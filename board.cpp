@@ -9,12 +9,108 @@
 
 #include "iterator"
 
+namespace {
+
+/**
+ * @brief Mixes a 64-bit value with the splitmix64 finalizer. Used to derive
+ * Zobrist keys on the fly instead of storing a table for every board size.
+ */
+std::uint64_t mix_bits(std::uint64_t value) {
+  value += 0x9E3779B97F4A7C15ULL;
+  value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+  return value ^ (value >> 31);
+}
+
+/**
+ * @brief Returns the Zobrist key of a stone of a player on a cell.
+ */
+std::uint64_t get_zobrist_key(int cell_index, Cell_state player) {
+  return mix_bits(static_cast<std::uint64_t>(cell_index) * 2 +
+                  (player == Cell_state::Blue ? 0 : 1));
+}
+
+/**
+ * @brief Returns the hash of an empty board, which differs between sizes.
+ */
+std::uint64_t get_empty_board_hash(int board_size) {
+  return mix_bits(~static_cast<std::uint64_t>(board_size));
+}
+
+/**
+ * @brief The reusable buffers of the flood fills of one thread.
+ */
+struct Flood_fill_buffers {
+  // The generation of the fill that last visited each cell
+  std::vector<std::uint32_t> visit_stamps;
+  // The stack of cells to visit, at most one entry per cell
+  std::vector<int> cells_to_visit;
+  std::uint32_t generation = 0;
+
+  /**
+   * @brief Prepares a fill of a board with the given number of cells and
+   * returns its generation. The buffers only grow for a larger board.
+   */
+  std::uint32_t start_fill(std::size_t cell_count) {
+    if (visit_stamps.size() < cell_count) {
+      visit_stamps.resize(cell_count, 0);
+      cells_to_visit.resize(cell_count);
+    }
+    // Once the generations wrap around, old stamps could match again
+    if (++generation == 0) {
+      std::fill(visit_stamps.begin(), visit_stamps.end(), 0);
+      generation = 1;
+    }
+    return generation;
+  }
+};
+
+/**
+ * @brief Returns the flood fill buffers of the calling thread.
+ */
+Flood_fill_buffers& get_flood_fill_buffers() {
+  thread_local Flood_fill_buffers buffers;
+  return buffers;
+}
+
+// Distinguishes the canonical hashes of the two players to move
+const std::uint64_t red_to_move_key = 0xD1B54A32D192ED03ULL;
+
+/**
+ * @brief Returns the other player.
+ */
+Cell_state get_opponent(Cell_state player) {
+  return player == Cell_state::Blue ? Cell_state::Red : Cell_state::Blue;
+}
+
+/**
+ * @brief Returns the canonical hash candidate of the image of the position
+ * under a symmetry.
+ */
+std::uint64_t get_symmetric_key(std::uint64_t symmetric_hash,
+                                Board_symmetry symmetry,
+                                Cell_state player_to_move) {
+  if (swaps_colours(symmetry)) {
+    player_to_move = get_opponent(player_to_move);
+  }
+  return symmetric_hash ^
+         (player_to_move == Cell_state::Red ? red_to_move_key : 0);
+}
+
+}  // namespace
+
+bool swaps_colours(Board_symmetry symmetry) {
+  return symmetry == Board_symmetry::Transpose ||
+         symmetry == Board_symmetry::Anti_transpose;
+}
+
 Board::Board(int size)
     : board_size(size),
       board(size, std::vector<Cell_state>(size, Cell_state::Empty)) {
   if (size < 2) {
     throw std::invalid_argument("Board size cannot be less than 2.");
   }
+  symmetric_hashes.fill(get_empty_board_hash(size));
 }
 
 int Board::get_board_size() const { return board_size; }
@@ -29,6 +125,57 @@ bool Board::is_valid_move(int move_x, int move_y) const {
          (board[move_x][move_y] == Cell_state::Empty);
 }
 
+Cell_state Board::get_cell(int move_x, int move_y) const {
+  return board[move_x][move_y];
+}
+
+void Board::clear() {
+  for (auto& row : board) {
+    std::fill(row.begin(), row.end(), Cell_state::Empty);
+  }
+  symmetric_hashes.fill(get_empty_board_hash(board_size));
+}
+
+std::uint64_t Board::get_hash() const { return symmetric_hashes[0]; }
+
+std::uint64_t Board::get_canonical_hash(Cell_state player_to_move) const {
+  Board_symmetry symmetry = get_canonical_symmetry(player_to_move);
+  return get_symmetric_key(symmetric_hashes[static_cast<int>(symmetry)],
+                           symmetry, player_to_move);
+}
+
+Board_symmetry Board::get_canonical_symmetry(Cell_state player_to_move) const {
+  Board_symmetry canonical_symmetry = Board_symmetry::Identity;
+  std::uint64_t canonical_key = get_symmetric_key(
+      symmetric_hashes[0], Board_symmetry::Identity, player_to_move);
+  for (int index = 1; index < board_symmetry_count; ++index) {
+    Board_symmetry symmetry = static_cast<Board_symmetry>(index);
+    std::uint64_t key =
+        get_symmetric_key(symmetric_hashes[index], symmetry, player_to_move);
+    if (key < canonical_key) {
+      canonical_key = key;
+      canonical_symmetry = symmetry;
+    }
+  }
+  return canonical_symmetry;
+}
+
+std::pair<int, int> Board::transform_cell(const std::pair<int, int>& cell,
+                                          Board_symmetry symmetry) const {
+  const int last = board_size - 1;
+  switch (symmetry) {
+    case Board_symmetry::Rotation:
+      return std::make_pair(last - cell.first, last - cell.second);
+    case Board_symmetry::Transpose:
+      return std::make_pair(cell.second, cell.first);
+    case Board_symmetry::Anti_transpose:
+      return std::make_pair(last - cell.second, last - cell.first);
+    case Board_symmetry::Identity:
+    default:
+      return cell;
+  }
+}
+
 std::vector<std::pair<int, int>> Board::get_valid_moves() const {
   std::vector<std::pair<int, int>> valid_moves;
   for (int row = 0; row < board_size; ++row) {
@@ -41,7 +188,7 @@ std::vector<std::pair<int, int>> Board::get_valid_moves() const {
   return valid_moves;
 }
 
-void Board::make_move(int move_x, int move_y, Cell_state player) {
+Cell_state Board::make_move(int move_x, int move_y, Cell_state player) {
   // Check if the move is valid. If not, throw an exception.
   if (!is_valid_move(move_x, move_y)) {
     throw std::invalid_argument("Invalid move attempt at position (" +
@@ -51,6 +198,32 @@ void Board::make_move(int move_x, int move_y, Cell_state player) {
   // If the move is valid, place the player's Cell_state on the board at the
   // specified coordinates.
   board[move_x][move_y] = player;
+  toggle_stone_hashes(move_x, move_y, player);
+  // Only the new stone can have completed a connection
+  return check_winner_from(move_x, move_y);
+}
+
+void Board::toggle_stone_hashes(int move_x, int move_y, Cell_state player) {
+  // Keep the hash of every symmetric image of the position up to date
+  for (int index = 0; index < board_symmetry_count; ++index) {
+    Board_symmetry symmetry = static_cast<Board_symmetry>(index);
+    std::pair<int, int> image =
+        transform_cell(std::make_pair(move_x, move_y), symmetry);
+    symmetric_hashes[index] ^= get_zobrist_key(
+        image.first * board_size + image.second,
+        swaps_colours(symmetry) ? get_opponent(player) : player);
+  }
+}
+
+void Board::recompute_hashes() {
+  symmetric_hashes.fill(get_empty_board_hash(board_size));
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      if (board[row][col] != Cell_state::Empty) {
+        toggle_stone_hashes(row, col, board[row][col]);
+      }
+    }
+  }
 }
 
 bool Board::are_cells_connected(int first_cell_x, int first_cell_y,
@@ -69,81 +242,68 @@ bool Board::are_cells_connected(int first_cell_x, int first_cell_y,
   return false;
 }
 
-bool Board::depth_first_search(
-    int start_x, int start_y, int destination_x, int destination_y,
-    Cell_state player_symbol,
-    std::vector<std::vector<Cell_state>>& game_board_snapshot) const {
-  // Base case: if the current cell is the destination cell, a path has been
-  // found.
-  if (start_x == destination_x && start_y == destination_y) return true;
-  // Mark the current cell as empty to prevent loops during the DFS.
-  game_board_snapshot[start_x][start_y] = Cell_state::Empty;
-
-  // For each neighboring cell...
-  for (std::size_t i = 0; i < neighbour_offset_x.size(); ++i) {
-    int new_x = start_x + neighbour_offset_x[i];
-    int new_y = start_y + neighbour_offset_y[i];
-
-    // If the neighboring cell is within the bounds of the board and has the
-    // same symbol as the player_symbol...
-    if (is_within_bounds(new_x, new_y) &&
-        // Recursively perform a DFS from the neighboring cell.
-        game_board_snapshot[new_x][new_y] == player_symbol &&
-        depth_first_search(new_x, new_y, destination_x, destination_y,
-                           player_symbol, game_board_snapshot)) {
-      // If a path is found, restore the player's symbol in the current cell and
-      // return True.
-      game_board_snapshot[start_x][start_y] = player_symbol;
-      return true;
-    }
-  }
+Cell_state Board::check_winner() const {
+  if (connects_edges(Cell_state::Blue, -1)) return Cell_state::Blue;
+  if (connects_edges(Cell_state::Red, -1)) return Cell_state::Red;
+  // If no paths are found for either player, return Empty to signify that there
+  // is no winner yet
+  return Cell_state::Empty;
+}
 
-  // If no path is found from the current cell, restore the player's symbol in
-  // the current cell and return False.
-  game_board_snapshot[start_x][start_y] = player_symbol;
-  return false;
+Cell_state Board::check_winner_from(int move_x, int move_y) const {
+  const Cell_state player = board[move_x][move_y];
+  if (player == Cell_state::Empty) return Cell_state::Empty;
+  return connects_edges(player, move_x * board_size + move_y)
+             ? player
+             : Cell_state::Empty;
 }
 
-Cell_state Board::check_winner() const {
-  // Check for player B (top to bottom)
-  for (int top_row_index = 0; top_row_index < board_size; ++top_row_index) {
-    if (board[0][top_row_index] == Cell_state::Blue) {
-      for (int bottom_row_index = 0; bottom_row_index < board_size;
-           ++bottom_row_index) {
-        // Copy the current board to pass to the depth_first_search function
-        std::vector<std::vector<Cell_state>> board_copy = board;
-        // If a path is found between the top and bottom of the board for player
-        // Blue, return Blue as the winner
-        if (board[board_size - 1][bottom_row_index] == Cell_state::Blue &&
-            depth_first_search(0, top_row_index, board_size - 1,
-                               bottom_row_index, Cell_state::Blue,
-                               board_copy)) {
-          return Cell_state::Blue;
-        }
-      }
+bool Board::connects_edges(Cell_state player, int source_cell) const {
+  Flood_fill_buffers& buffers = get_flood_fill_buffers();
+  const std::uint32_t stamp = buffers.start_fill(
+      static_cast<std::size_t>(board_size) * board_size);
+  std::uint32_t* const visit_stamps = buffers.visit_stamps.data();
+  int* const cells_to_visit = buffers.cells_to_visit.data();
+  int cell_count = 0;
+  // Every cell is stamped when pushed, so it is pushed at most once
+  const auto push_cell = [&](int cell) {
+    visit_stamps[cell] = stamp;
+    cells_to_visit[cell_count++] = cell;
+  };
+  // Blue connects the top and the bottom row, Red the left and the right
+  // column
+  const bool is_blue = player == Cell_state::Blue;
+  if (source_cell >= 0) {
+    push_cell(source_cell);
+  } else {
+    for (int i = 0; i < board_size; ++i) {
+      const int x = is_blue ? 0 : i;
+      const int y = is_blue ? i : 0;
+      if (board[x][y] == player) push_cell(x * board_size + y);
     }
   }
-  // Check for player R (left to right)
-  for (int left_column_index = 0; left_column_index < board_size;
-       ++left_column_index) {
-    if (board[left_column_index][0] == Cell_state::Red) {
-      for (int right_column_index = 0; right_column_index < board_size;
-           ++right_column_index) {
-        // Copy the current board to pass to the depth_first_search function
-        std::vector<std::vector<Cell_state>> board_copy = board;
-        // If a path is found between the left and right of the board for player
-        // Red, return Red as the winner
-        if (board[right_column_index][board_size - 1] == Cell_state::Red &&
-            depth_first_search(left_column_index, 0, right_column_index,
-                               board_size - 1, Cell_state::Red, board_copy)) {
-          return Cell_state::Red;
-        }
+  bool touches_first_edge = false;
+  bool touches_second_edge = false;
+  while (cell_count > 0) {
+    const int cell = cells_to_visit[--cell_count];
+    const int x = cell / board_size;
+    const int y = cell % board_size;
+    const int edge_coordinate = is_blue ? x : y;
+    touches_first_edge = touches_first_edge || edge_coordinate == 0;
+    touches_second_edge =
+        touches_second_edge || edge_coordinate == board_size - 1;
+    if (touches_first_edge && touches_second_edge) return true;
+    for (std::size_t i = 0; i < neighbour_offset_x.size(); ++i) {
+      const int neighbour_x = x + neighbour_offset_x[i];
+      const int neighbour_y = y + neighbour_offset_y[i];
+      if (is_within_bounds(neighbour_x, neighbour_y) &&
+          board[neighbour_x][neighbour_y] == player) {
+        const int neighbour_cell = neighbour_x * board_size + neighbour_y;
+        if (visit_stamps[neighbour_cell] != stamp) push_cell(neighbour_cell);
       }
     }
   }
-  // If no paths are found for either player, return Empty to signify that there
-  // is no winner yet
-  return Cell_state::Empty;
+  return false;
 }
 
 void Board::display_board(std::ostream& os = std::cout) const {
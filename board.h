@@ -2,12 +2,42 @@
 #define BOARD_H
 
 #include <array>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "cell_state.h"
 
+/**
+ * @brief The symmetries of a Hex board.
+ *
+ * Rotating the board by 180 degrees keeps every player's edges, and
+ * transposing it (mirroring along the short diagonal) swaps the edges of the
+ * two players, so a transposed position is equivalent once the colours of the
+ * stones and of the player to move are swapped as well. Every symmetry is its
+ * own inverse.
+ */
+enum class Board_symmetry {
+  Identity,       ///< The board itself.
+  Rotation,       ///< Rotation by 180 degrees.
+  Transpose,      ///< Row and column exchanged, colours swapped.
+  Anti_transpose  ///< Transpose followed by rotation, colours swapped.
+};
+
+/**
+ * @brief The number of Board_symmetry values.
+ */
+const int board_symmetry_count = 4;
+
+/**
+ * @brief Checks whether a symmetry swaps the colours of the players.
+ *
+ * @param symmetry The symmetry.
+ * @return True for the transposing symmetries.
+ */
+bool swaps_colours(Board_symmetry symmetry);
+
 /**
  * @brief The Board class represents the game board for a game of Hex.
  *
@@ -27,6 +57,7 @@
  * their pieces across the board).
  * - Getting a list of all valid moves on the board.
  * - Checking if two cells on the board are connected.
+ * - Hashing the position, also canonically under the board symmetries.
  *
  * The Board class also overloads the << operator to enable printing the board
  * directly to an output stream.
@@ -72,6 +103,89 @@ class Board {
    */
   bool is_valid_move(int move_x, int move_y) const;
 
+  /**
+   * @brief Getter for the state of a cell.
+   *
+   * @param move_x: The x-coordinate (row) of the cell. Must be within bounds.
+   * @param move_y: The y-coordinate (column) of the cell. Must be within
+   * bounds.
+   * @return The Cell_state of the cell.
+   */
+  Cell_state get_cell(int move_x, int move_y) const;
+
+  /**
+   * @brief Empties every cell of the board, keeping its size and storage.
+   */
+  void clear();
+
+  /**
+   * @brief Overwrites every cell from a position stored elsewhere, then
+   * recomputes the hashes once.
+   *
+   * Unlike a sequence of make_move() calls, this neither validates the stones
+   * nor checks for a winner, so decoding a stored position costs one write
+   * per cell.
+   *
+   * @param source: Any object with a get_cell(row, column) member returning
+   * the Cell_state of a cell of a board of the same size, e.g. a
+   * Position_view.
+   */
+  template <typename Cell_source>
+  void assign_cells(const Cell_source& source) {
+    for (int row = 0; row < board_size; ++row) {
+      for (int col = 0; col < board_size; ++col) {
+        board[row][col] = source.get_cell(row, col);
+      }
+    }
+    recompute_hashes();
+  }
+
+  /**
+   * @brief Getter for the Zobrist hash of the stones on the board.
+   *
+   * The hash is updated incrementally by make_move() and identifies the
+   * position (including the board size) with a negligible collision
+   * probability. It does not include the player to move.
+   *
+   * @return The 64-bit hash of the position.
+   */
+  std::uint64_t get_hash() const;
+
+  /**
+   * @brief Computes a hash that is identical for all positions equivalent
+   * under the board symmetries.
+   *
+   * The hashes of the four symmetric images of the position are maintained
+   * incrementally alongside get_hash(), so the canonical hash is the smallest
+   * of four values and costs no board traversal. Caches keyed by it store a
+   * single entry for up to four equivalent positions.
+   *
+   * @param player_to_move The player to move, which is part of the key
+   * because the transposing symmetries swap it.
+   * @return The 64-bit canonical hash of the position.
+   */
+  std::uint64_t get_canonical_hash(Cell_state player_to_move) const;
+
+  /**
+   * @brief Returns the symmetry that maps the position to its canonical form,
+   * i.e. the one whose hash is get_canonical_hash().
+   *
+   * @param player_to_move The player to move.
+   * @return The canonicalizing symmetry. Moves of the position are mapped to
+   * the canonical form, and back, with transform_cell().
+   */
+  Board_symmetry get_canonical_symmetry(Cell_state player_to_move) const;
+
+  /**
+   * @brief Maps a cell to its image under a symmetry.
+   *
+   * @param cell The cell, row first, column second.
+   * @param symmetry The symmetry to apply.
+   * @return The image of the cell.
+   */
+  std::pair<int, int> transform_cell(const std::pair<int, int>& cell,
+                                     Board_symmetry symmetry) const;
+
   /**
    * @brief Get all valid moves on the board.
    *
@@ -89,14 +203,20 @@ class Board {
    * the specified x and y coordinates. If the move is invalid, an exception is
    * thrown.
    *
+   * The move wins if the new stone connects the player's edges, which is
+   * checked with check_winner_from() on the group of the stone only, so a
+   * game loop needs no separate check_winner() sweep.
+   *
    * @param move_x: The x-coordinate (row) of the move.
    * @param move_y: The y-coordinate (column) of the move.
    * @param player: The player making the move (Cell_state).
    *
+   * @return The player if the move wins the game, else Cell_state::Empty.
+   *
    * @exception std::invalid_argument If the move is invalid, i.e., it's outside
    * the board boundaries or the target cell is not empty.
    */
-  void make_move(int move_x, int move_y, Cell_state player);
+  Cell_state make_move(int move_x, int move_y, Cell_state player);
 
   /**
    * @brief Checks if two cells on the board are connected.
@@ -119,49 +239,39 @@ class Board {
   bool are_cells_connected(int first_cell_x, int first_cell_y,
                            int second_cell_x, int second_cell_y) const;
 
-  /**
-   * @brief A Depth-First Search (DFS) algorithm to check if there is a path
-   * from the start cell to the destination cell.
-   *
-   * The DFS is performed recursively, starting from the start cell and
-   * exploring the neighboring cells. A cell is considered reachable if it is
-   * within the bounds of the board and has the same symbol as the
-   * player_symbol. During the search, the explored cells are temporarily marked
-   * as empty in the game_board_snapshot to prevent loops.
-   *
-   * @param start_x: The x-coordinate (row) of the starting cell for the DFS.
-   * @param start_y: The y-coordinate (column) of the starting cell for the DFS.
-   * @param destination_x: The x-coordinate (row) of the destination cell.
-   * @param destination_y: The y-coordinate (column) of the destination cell.
-   * @param player_symbol: The symbol (Cell_state) of the player for whom the
-   * path is being checked.
-   * @param game_board_snapshot: A snapshot of the game board state, represented
-   * as a 2D vector. It is used to keep track of the cells that have been
-   * explored during the DFS. It is passed by reference to avoid copying the
-   * entire game board at each recursive call.
-   *
-   * @return True if there is a path from the start cell to the destination
-   * cell, else False.
-   */
-  bool depth_first_search(
-      int start_x, int start_y, int destination_x, int destination_y,
-      Cell_state player_symbol,
-      std::vector<std::vector<Cell_state>>& game_board_snapshot) const;
-
   /**
    * @brief Checks if there is a winner in the game.
    *
    * This function checks for a winning path for both players (Blue and Red).
    * For Blue, it checks for a path from any cell in the top row to any cell in
    * the bottom row. For Red, it checks for a path from any cell in the leftmost
-   * column to any cell in the rightmost column. The function utilizes the
-   * depth_first_search method to find a path.
+   * column to any cell in the rightmost column. Each check is one flood fill
+   * from all the stones of the player on its first edge, see connects_edges().
    *
    * @return The Cell_state of the winning player. If there is no winner, it
    * returns Cell_state::Empty.
    */
   Cell_state check_winner() const;
 
+  /**
+   * @brief Checks whether the stone on a cell connects the edges of its
+   * player.
+   *
+   * Only the stone placed last can complete a connection, so checking its
+   * group is enough to detect a win after each move. The group is flood
+   * filled from the cell, recording whether it touches each of the player's
+   * edges, and the fill stops as soon as it touches both, see
+   * connects_edges(). The cost is proportional to the size of the group
+   * instead of the board.
+   *
+   * @param move_x: The x-coordinate (row) of the stone.
+   * @param move_y: The y-coordinate (column) of the stone.
+   *
+   * @return The player of the stone if its group connects the player's edges,
+   * else Cell_state::Empty, also for an empty cell.
+   */
+  Cell_state check_winner_from(int move_x, int move_y) const;
+
   /**
    * @brief Outputs the current state of the board to an output stream.
    * The board is displayed in a hexagonal pattern, with each cell represented
@@ -185,6 +295,38 @@ class Board {
   friend std::ostream& operator<<(std::ostream& os, const Board& board);
 
  private:
+  /**
+   * @brief Adds a stone of a player to the hashes of every symmetric image
+   * of the position, or removes it, as the keys are combined by XOR.
+   */
+  void toggle_stone_hashes(int move_x, int move_y, Cell_state player);
+
+  /**
+   * @brief Recomputes the hashes from the cells of the board.
+   */
+  void recompute_hashes();
+
+  /**
+   * @brief Flood fills stones of a player and checks whether they connect the
+   * player's edges: the top and the bottom row for Blue, the left and the
+   * right column for Red.
+   *
+   * The fill is iterative, with an explicit stack of at most one entry per
+   * cell, so it cannot overflow the call stack on any board size. The stack
+   * and the visited marks are thread-local buffers reused across calls: a
+   * cell counts as visited if its stamp equals the generation of the current
+   * fill, so no buffer is cleared or allocated once it has grown to the
+   * board size.
+   *
+   * @param player: The player whose stones are filled.
+   * @param source_cell: The index (row * board size + column) of the stone
+   * the fill starts from, or -1 to start from every stone of the player on
+   * its first edge.
+   *
+   * @return True if the filled stones touch both edges of the player.
+   */
+  bool connects_edges(Cell_state player, int source_cell) const;
+
   /**
    * @brief The size of the board.
    */
@@ -197,6 +339,12 @@ class Board {
    */
   std::vector<std::vector<Cell_state>> board;
 
+  /**
+   * @brief The Zobrist hashes of the stones on the board under each
+   * Board_symmetry, indexed by the symmetry. The first one is get_hash().
+   */
+  std::array<std::uint64_t, board_symmetry_count> symmetric_hashes;
+
   /**
    * @brief An array storing the x offsets for the six possible directions
    * in the Hex game. It is used to find neighbouring cells on the board.
@@ -0,0 +1,272 @@
+#include "board_evaluation.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const std::array<int, 6> neighbour_offset_x = {-1, -1, 0, 1, 1, 0};
+const std::array<int, 6> neighbour_offset_y = {0, 1, 1, 0, -1, -1};
+
+// Weights of the features of get_move_heuristic(), summing to 1
+const double centre_weight = 0.4;
+const double contact_weight = 0.2;
+const double bridge_weight = 0.4;
+
+// Steepness of the logistic mapping from potential differences to win
+// probabilities, per cell of difference
+const double evaluation_sharpness = 0.5;
+
+/**
+ * @brief The empty cells of a position and the cells each of them treats as
+ * neighbours, seen by one player.
+ */
+struct Connection_graph {
+  int board_size;
+  /// Indices of the empty cells in row-major order.
+  std::vector<int> empty_cells;
+  /// For each empty cell, the empty cells adjacent to it directly or through
+  /// a group of the player, without duplicates.
+  std::vector<std::vector<int>> neighbours;
+  /// For each empty cell and each edge of the player, whether the cell touches
+  /// the edge directly or through a group.
+  std::vector<std::array<bool, 2>> touches_edge;
+};
+
+bool is_on_board(int board_size, int row, int col) {
+  return row >= 0 && row < board_size && col >= 0 && col < board_size;
+}
+
+/**
+ * @brief Returns which edges of a player a cell lies on.
+ */
+std::array<bool, 2> get_edges_of_cell(int board_size, int row, int col,
+                                      Cell_state player) {
+  const int line = player == Cell_state::Blue ? row : col;
+  return {{line == 0, line == board_size - 1}};
+}
+
+Connection_graph build_connection_graph(const Board& board,
+                                        Cell_state player) {
+  Connection_graph graph;
+  const int board_size = board.get_board_size();
+  graph.board_size = board_size;
+  const int cell_count = board_size * board_size;
+
+  // Label the groups of the player and collect their liberties and edges
+  std::vector<int> group_of_cell(cell_count, -1);
+  std::vector<std::vector<int>> group_liberties;
+  std::vector<std::array<bool, 2>> group_edges;
+  std::vector<int> stack;
+  std::vector<int> liberty_stamp(cell_count, -1);
+  for (int start = 0; start < cell_count; ++start) {
+    if (board.get_cell(start / board_size, start % board_size) != player ||
+        group_of_cell[start] >= 0) {
+      continue;
+    }
+    const int group = static_cast<int>(group_liberties.size());
+    group_liberties.emplace_back();
+    group_edges.push_back({{false, false}});
+    group_of_cell[start] = group;
+    stack.push_back(start);
+    while (!stack.empty()) {
+      const int cell = stack.back();
+      stack.pop_back();
+      const int row = cell / board_size;
+      const int col = cell % board_size;
+      std::array<bool, 2> edges = get_edges_of_cell(board_size, row, col,
+                                                    player);
+      group_edges[group][0] = group_edges[group][0] || edges[0];
+      group_edges[group][1] = group_edges[group][1] || edges[1];
+      for (int direction = 0; direction < 6; ++direction) {
+        const int neighbour_row = row + neighbour_offset_x[direction];
+        const int neighbour_col = col + neighbour_offset_y[direction];
+        if (!is_on_board(board_size, neighbour_row, neighbour_col)) continue;
+        const int neighbour = neighbour_row * board_size + neighbour_col;
+        Cell_state state = board.get_cell(neighbour_row, neighbour_col);
+        if (state == player && group_of_cell[neighbour] < 0) {
+          group_of_cell[neighbour] = group;
+          stack.push_back(neighbour);
+        } else if (state == Cell_state::Empty &&
+                   liberty_stamp[neighbour] != group) {
+          liberty_stamp[neighbour] = group;
+          group_liberties[group].push_back(neighbour);
+        }
+      }
+    }
+  }
+
+  // Number the empty cells and gather their neighbours
+  std::vector<int> empty_index(cell_count, -1);
+  for (int cell = 0; cell < cell_count; ++cell) {
+    if (board.get_cell(cell / board_size, cell % board_size) ==
+        Cell_state::Empty) {
+      empty_index[cell] = static_cast<int>(graph.empty_cells.size());
+      graph.empty_cells.push_back(cell);
+    }
+  }
+  graph.neighbours.resize(graph.empty_cells.size());
+  graph.touches_edge.resize(graph.empty_cells.size());
+  std::vector<int> neighbour_stamp(cell_count, -1);
+  for (std::size_t index = 0; index < graph.empty_cells.size(); ++index) {
+    const int cell = graph.empty_cells[index];
+    const int row = cell / board_size;
+    const int col = cell % board_size;
+    std::vector<int>& neighbours = graph.neighbours[index];
+    graph.touches_edge[index] = get_edges_of_cell(board_size, row, col,
+                                                  player);
+    neighbour_stamp[cell] = static_cast<int>(index);
+    auto add_neighbour = [&](int neighbour) {
+      if (neighbour_stamp[neighbour] != static_cast<int>(index)) {
+        neighbour_stamp[neighbour] = static_cast<int>(index);
+        neighbours.push_back(empty_index[neighbour]);
+      }
+    };
+    for (int direction = 0; direction < 6; ++direction) {
+      const int neighbour_row = row + neighbour_offset_x[direction];
+      const int neighbour_col = col + neighbour_offset_y[direction];
+      if (!is_on_board(board_size, neighbour_row, neighbour_col)) continue;
+      const int neighbour = neighbour_row * board_size + neighbour_col;
+      if (empty_index[neighbour] >= 0) {
+        add_neighbour(neighbour);
+      } else if (group_of_cell[neighbour] >= 0) {
+        const int group = group_of_cell[neighbour];
+        graph.touches_edge[index][0] =
+            graph.touches_edge[index][0] || group_edges[group][0];
+        graph.touches_edge[index][1] =
+            graph.touches_edge[index][1] || group_edges[group][1];
+        for (int liberty : group_liberties[group]) {
+          add_neighbour(liberty);
+        }
+      }
+    }
+  }
+  return graph;
+}
+
+/**
+ * @brief Computes the two-distances of the empty cells from one edge by
+ * relaxing the cells until no distance decreases.
+ */
+std::vector<int> compute_two_distances(const Connection_graph& graph,
+                                       int edge, int unreachable) {
+  std::vector<int> distances(graph.empty_cells.size(), unreachable);
+  for (std::size_t index = 0; index < distances.size(); ++index) {
+    if (graph.touches_edge[index][edge]) distances[index] = 1;
+  }
+  bool is_changed = true;
+  while (is_changed) {
+    is_changed = false;
+    for (std::size_t index = 0; index < distances.size(); ++index) {
+      if (distances[index] == 1) continue;
+      int best = unreachable;
+      int second_best = unreachable;
+      for (int neighbour : graph.neighbours[index]) {
+        const int distance = distances[neighbour];
+        if (distance < best) {
+          second_best = best;
+          best = distance;
+        } else if (distance < second_best) {
+          second_best = distance;
+        }
+      }
+      if (second_best + 1 < distances[index]) {
+        distances[index] = second_best + 1;
+        is_changed = true;
+      }
+    }
+  }
+  return distances;
+}
+
+}  // namespace
+
+int get_two_distance_potential(const Board& board, Cell_state player) {
+  const int board_size = board.get_board_size();
+  // Larger than any reachable potential, and small enough not to overflow
+  const int unreachable = 2 * board_size * board_size + 1;
+  const Connection_graph graph = build_connection_graph(board, player);
+  const std::vector<int> first_distances =
+      compute_two_distances(graph, 0, unreachable);
+  const std::vector<int> second_distances =
+      compute_two_distances(graph, 1, unreachable);
+  int potential = unreachable;
+  for (std::size_t index = 0; index < graph.empty_cells.size(); ++index) {
+    potential = std::min(potential,
+                         std::min(unreachable, first_distances[index] +
+                                                   second_distances[index]));
+  }
+  return potential;
+}
+
+double evaluate_position(const Board& board, Cell_state player) {
+  const Cell_state opponent =
+      player == Cell_state::Blue ? Cell_state::Red : Cell_state::Blue;
+  const int advantage = get_two_distance_potential(board, opponent) -
+                        get_two_distance_potential(board, player);
+  return 1. / (1. + std::exp(-evaluation_sharpness * advantage));
+}
+
+double get_move_heuristic(const Board& board, const std::pair<int, int>& move,
+                          Cell_state player) {
+  const int board_size = board.get_board_size();
+  const Cell_state opponent =
+      player == Cell_state::Blue ? Cell_state::Red : Cell_state::Blue;
+  // Hex distance to the centre, which is 0 at the centre and at most
+  // board_size - 1 in the obtuse corners
+  const double centre = (board_size - 1) / 2.;
+  const double row_offset = move.first - centre;
+  const double col_offset = move.second - centre;
+  const double centre_distance =
+      (std::abs(row_offset) + std::abs(col_offset) +
+       std::abs(row_offset + col_offset)) /
+      2.;
+  const double centrality = 1. - centre_distance / (board_size - 1);
+
+  // The neighbours in order around the move, with the edges as stones of
+  // their owner
+  std::array<Cell_state, 6> ring;
+  for (int direction = 0; direction < 6; ++direction) {
+    const int row = move.first + neighbour_offset_x[direction];
+    const int col = move.second + neighbour_offset_y[direction];
+    if (row < 0 || row >= board_size) {
+      ring[direction] = Cell_state::Blue;
+    } else if (col < 0 || col >= board_size) {
+      ring[direction] = Cell_state::Red;
+    } else {
+      ring[direction] = board.get_cell(row, col);
+    }
+  }
+
+  int contact_count = 0;
+  double bridge_score = 0.;
+  for (int direction = 0; direction < 6; ++direction) {
+    const int next_direction = (direction + 1) % 6;
+    const int previous_direction = (direction + 5) % 6;
+    const int row = move.first + neighbour_offset_x[direction];
+    const int col = move.second + neighbour_offset_y[direction];
+    if (is_on_board(board_size, row, col) &&
+        board.get_cell(row, col) != Cell_state::Empty) {
+      ++contact_count;
+    }
+    // The move restores a bridge whose other carrier cell the opponent took
+    if (ring[previous_direction] == player && ring[next_direction] == player &&
+        ring[direction] == opponent) {
+      bridge_score = 1.;
+    }
+    // The move forms a bridge with a stone of the player
+    const int partner_row = row + neighbour_offset_x[next_direction];
+    const int partner_col = col + neighbour_offset_y[next_direction];
+    if (is_on_board(board_size, partner_row, partner_col) &&
+        board.get_cell(partner_row, partner_col) == player &&
+        ring[direction] == Cell_state::Empty &&
+        ring[next_direction] == Cell_state::Empty) {
+      bridge_score = std::max(bridge_score, 0.5);
+    }
+  }
+  const double contact = std::min(1., contact_count / 2.);
+  return centre_weight * centrality + contact_weight * contact +
+         bridge_weight * bridge_score;
+}
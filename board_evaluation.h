@@ -0,0 +1,59 @@
+#ifndef BOARD_EVALUATION_H
+#define BOARD_EVALUATION_H
+
+#include <utility>
+
+#include "board.h"
+#include "cell_state.h"
+
+/**
+ * @brief Computes the two-distance potential of a player, i.e. the number of
+ * empty cells the player still has to fill to connect their edges when the
+ * opponent always blocks the best route.
+ *
+ * The two-distance of an empty cell from an edge is 1 if the cell touches the
+ * edge, and otherwise one more than the second smallest two-distance among
+ * its neighbours, since the opponent can always block the best one. Stones of
+ * the player are transparent: the empty cells around a group count as
+ * neighbours of each other, and a group touching the edge extends it. The
+ * potential is the smallest sum of the two-distances from both edges over the
+ * empty cells. Lower is better.
+ *
+ * @param board The state of the game board.
+ * @param player The player whose potential is computed.
+ * @return The potential, or a value above the number of cells if the player
+ * can no longer connect.
+ */
+int get_two_distance_potential(const Board& board, Cell_state player);
+
+/**
+ * @brief Estimates the probability that a player wins a position, from the
+ * difference of the two-distance potentials of both players.
+ *
+ * The evaluation costs a few passes over the board, which is much cheaper
+ * than completing a random playout on a large board, and considers every
+ * route instead of a single random game.
+ *
+ * @param board The state of the game board, with no winner yet.
+ * @param player The player to evaluate the position for.
+ * @return A probability between 0 and 1, 0.5 for balanced potentials.
+ */
+double evaluate_position(const Board& board, Cell_state player);
+
+/**
+ * @brief Scores a move with cheap local knowledge, without searching.
+ *
+ * The score combines the closeness of the move to the centre, contact with
+ * stones already on the board, and a small table of bridge patterns: moves
+ * forming a bridge with a stone of the player score higher, and moves
+ * restoring a bridge after an intrusion score highest.
+ *
+ * @param board The state of the game board before the move.
+ * @param move The move, row first, column second. Must be a valid move.
+ * @param player The player making the move.
+ * @return A score between 0 and 1, higher for more promising moves.
+ */
+double get_move_heuristic(const Board& board, const std::pair<int, int>& move,
+                          Cell_state player);
+
+#endif  // BOARD_EVALUATION_H
@@ -1,10 +1,15 @@
 #include "console_interface.h"
 
+#include <algorithm>
 #include <chrono>
-#include <thread>
 #include <climits>
+#include <fstream>
+#include <thread>
 
+#include "analysis_server.h"
+#include "batch_analysis.h"
 #include "board.h"
+#include "htp_engine.h"
 
 bool is_integer(const std::string& s) {
   std::string::const_iterator it = s.begin();
@@ -95,6 +100,64 @@ double get_parameter_within_bounds<double>(const std::string& prompt,
   return value;
 }
 
+void configure_advanced_search_options(Mcts_player& mcts_player) {
+  Search_options options;
+  if (get_yes_or_no_response("Would you like to cut playouts off and score "
+                             "them statically? (y/n): ") == 'y') {
+    options.playout_cutoff_depth = get_parameter_within_bounds(
+        "Enter the number of random moves per playout (at least 1): ", 1,
+        INT_MAX);
+  }
+  if (get_yes_or_no_response("Would you like to seed the search with prior "
+                             "knowledge of the moves? (y/n): ") == 'y') {
+    options.prior_visit_count = get_parameter_within_bounds(
+        "Enter the number of virtual playouts per move (at least 0): ", 0,
+        INT_MAX);
+    options.progressive_bias_weight = get_parameter_within_bounds(
+        "Enter the progressive bias weight (between 0 and 10): ", 0.0, 10.0);
+  }
+  if (get_yes_or_no_response("Would you like to widen the search "
+                             "progressively? (y/n): ") == 'y') {
+    options.widening_constant = get_parameter_within_bounds(
+        "Enter the number of moves considered at first (between 1 and 400): ",
+        1.0, 400.0);
+    options.widening_exponent = get_parameter_within_bounds(
+        "Enter the growth exponent of the moves considered (between 0 and 1): ",
+        0.0, 1.0);
+  }
+  if (get_yes_or_no_response("Would you like to change the selection policy "
+                             "(UCB1)? (y/n): ") == 'y') {
+    const Selection_policy_type policies[] = {
+        Selection_policy_type::Ucb1, Selection_policy_type::Ucb1_tuned,
+        Selection_policy_type::Puct, Selection_policy_type::Thompson};
+    int policy_number = get_parameter_within_bounds(
+        "Enter '1' for UCB1, '2' for UCB1-Tuned, '3' for PUCT or '4' for "
+        "Thompson sampling: ",
+        1, 4);
+    options.selection_policy = policies[policy_number - 1];
+  }
+  if (get_yes_or_no_response("Would you like to change how the final move is "
+                             "chosen (highest win ratio)? (y/n): ") == 'y') {
+    const Final_move_criterion criteria[] = {
+        Final_move_criterion::Max_value, Final_move_criterion::Most_visits,
+        Final_move_criterion::Robust_max, Final_move_criterion::Secure_child};
+    int criterion_number = get_parameter_within_bounds(
+        "Enter '1' for the highest win ratio, '2' for the most visits, '3' "
+        "for robust-max or '4' for the secure child: ",
+        1, 4);
+    options.final_move_criterion = criteria[criterion_number - 1];
+  }
+  if (get_yes_or_no_response("Would you like to extend the search while the "
+                             "most visited and the most valuable moves "
+                             "disagree? (y/n): ") == 'y') {
+    options.search_extension_ratio = get_parameter_within_bounds(
+        "Enter the longest extension as a multiple of the decision time "
+        "(between 0.1 and 4): ",
+        0.1, 4.0);
+  }
+  mcts_player.set_search_options(options);
+}
+
 std::unique_ptr<Mcts_player> create_mcts_agent(
     const std::string& agent_prompt) {
   std::cout << "\nInitializing " << agent_prompt << ":\n";
@@ -113,15 +176,37 @@ std::unique_ptr<Mcts_player> create_mcts_agent(
       (get_yes_or_no_response(
            "Would you like to parallelize the agent? (y/n): ") == 'y');
 
-  bool is_verbose = false;
-  if (!is_parallelized) {
-    is_verbose = (get_yes_or_no_response(
-                      "Would you like to enable verbose mode? (y/n): ") == 'y');
-  }
+  bool is_verbose =
+      (get_yes_or_no_response(
+           "Would you like to enable verbose mode? (y/n): ") == 'y');
 
-  return std::make_unique<Mcts_player>(
+  auto mcts_player = std::make_unique<Mcts_player>(
       exploration_constant, std::chrono::milliseconds(max_decision_time_ms),
       is_parallelized, is_verbose);
+
+  if (get_yes_or_no_response(
+          "Would you like to configure advanced search options? (y/n): ") ==
+      'y') {
+    configure_advanced_search_options(*mcts_player);
+  }
+
+  if (get_yes_or_no_response(
+          "Would you like to use an opening book? (y/n): ") == 'y') {
+    std::string book_path;
+    std::cout << "Enter the opening book file path: ";
+    std::cin >> book_path;
+    mcts_player->set_opening_book(std::make_shared<Opening_book>(book_path));
+  }
+
+  if (get_yes_or_no_response(
+          "Would you like to record a binary search trace? (y/n): ") == 'y') {
+    std::string trace_path;
+    std::cout << "Enter the trace file path: ";
+    std::cin >> trace_path;
+    mcts_player->set_trace_file(trace_path);
+  }
+
+  return mcts_player;
 }
 
 void countdown(int seconds) {
@@ -133,6 +218,26 @@ void countdown(int seconds) {
   }
 }
 
+bool ask_for_swap_rule() {
+  return get_yes_or_no_response(
+             "Would you like to play with the swap rule? (y/n): ") == 'y';
+}
+
+void offer_to_save_game_record(const Game& game) {
+  if (get_yes_or_no_response(
+          "Would you like to save the game record as SGF? (y/n): ") != 'y') {
+    return;
+  }
+  std::string record_path;
+  std::cout << "Enter the SGF file path (the game is appended): ";
+  std::cin >> record_path;
+  std::ofstream record_file(record_path, std::ios::app);
+  if (!record_file) {
+    throw std::runtime_error("Cannot open " + record_path + ".");
+  }
+  Sgf_writer(record_file).write(game.get_record());
+}
+
 void start_match_against_robot() {
   int human_player_number = get_parameter_within_bounds(
       "Enter '1' if you want to be Player 1 (Blue, Vertical) or '2' if you "
@@ -142,39 +247,58 @@ void start_match_against_robot() {
   int board_size = get_parameter_within_bounds(
       "Enter board size (between 2 and 11): ", 2, 11);
 
+  bool is_swap_rule_enabled = ask_for_swap_rule();
   auto mcts_agent = create_mcts_agent("agent");
   auto human_player = std::make_unique<Human_player>();
 
   if (human_player_number == 1) {
-    Game game(board_size, std::move(human_player), std::move(mcts_agent));
+    Game game(board_size, std::move(human_player), std::move(mcts_agent),
+              is_swap_rule_enabled);
     game.play();
+    offer_to_save_game_record(game);
   } else {
     if (mcts_agent->get_is_verbose()) {
       countdown(3);
     }
-    Game game(board_size, std::move(mcts_agent), std::move(human_player));
+    Game game(board_size, std::move(mcts_agent), std::move(human_player),
+              is_swap_rule_enabled);
     game.play();
+    offer_to_save_game_record(game);
   }
 }
 
 void start_robot_arena() {
   int board_size = get_parameter_within_bounds(
       "Enter board size (between 2 and 11): ", 2, 11);
+  bool is_swap_rule_enabled = ask_for_swap_rule();
 
   auto mcts_agent_1 = create_mcts_agent("first agent");
   auto mcts_agent_2 = create_mcts_agent("second agent");
+  const bool is_rendering =
+      get_yes_or_no_response("Would you like to watch every move? (y/n): ") ==
+      'y';
 
-  Game game(board_size, std::move(mcts_agent_1), std::move(mcts_agent_2));
+  Game game(board_size, std::move(mcts_agent_1), std::move(mcts_agent_2),
+            is_swap_rule_enabled, is_rendering);
   game.play();
+  if (!is_rendering) {
+    const Game_record& record = game.get_record();
+    std::cout << "\nPlayer " << record.get_winner() << " wins after "
+              << record.get_moves().size() << " moves." << std::endl;
+  }
+  offer_to_save_game_record(game);
 }
 
 void start_human_arena() {
   int board_size = get_parameter_within_bounds(
       "Enter board size (between 2 and 11): ", 2, 11);
+  bool is_swap_rule_enabled = ask_for_swap_rule();
   auto human_player_1 = std::make_unique<Human_player>();
   auto human_player_2 = std::make_unique<Human_player>();
-  Game game(board_size, std::move(human_player_1), std::move(human_player_2));
+  Game game(board_size, std::move(human_player_1), std::move(human_player_2),
+            is_swap_rule_enabled);
   game.play();
+  offer_to_save_game_record(game);
 }
 
 void run_console_interface() {
@@ -225,6 +349,97 @@ void run_console_interface() {
   print_exit_ascii_art();
 }
 
+void print_command_line_usage() {
+  std::cout << "Usage:\n"
+            << "  MCTS-Hex\n"
+            << "      Runs the interactive console interface.\n"
+            << "  MCTS-Hex --build-book <file> <board size> <plies> "
+               "<milliseconds per position> [--parallel]\n"
+            << "      Builds an opening book with MCTS searches.\n"
+            << "  MCTS-Hex --htp [<milliseconds per move>] [--parallel]\n"
+            << "      Runs an engine speaking the Hex Text Protocol on the "
+               "standard input and output.\n"
+            << "  MCTS-Hex --server <port> [<threads>]\n"
+            << "      Serves analysis requests of many games on a local TCP "
+               "port.\n"
+            << "  MCTS-Hex --batch <input> <output> <milliseconds per "
+               "position> [<top k>] [<threads>]\n"
+            << "      Analyses the positions of an SGF collection or a "
+               "position database into JSON lines.\n";
+}
+
+int run_command_line(const std::vector<std::string>& arguments) {
+  try {
+    if ((arguments.size() == 5 || arguments.size() == 6) &&
+        arguments[0] == "--build-book" && is_integer(arguments[2]) &&
+        is_integer(arguments[3]) && is_integer(arguments[4]) &&
+        (arguments.size() == 5 || arguments[5] == "--parallel")) {
+      Opening_book::build(arguments[1], std::stoi(arguments[2]),
+                          std::stoi(arguments[3]), 1.41,
+                          std::chrono::milliseconds(std::stoi(arguments[4])),
+                          arguments.size() == 6);
+      return 0;
+    }
+    if (!arguments.empty() && arguments.size() <= 3 &&
+        arguments[0] == "--htp") {
+      std::vector<std::string> options(arguments.begin() + 1, arguments.end());
+      const bool is_parallelized =
+          !options.empty() && options.back() == "--parallel";
+      if (is_parallelized) {
+        options.pop_back();
+      }
+      if (options.empty() || (options.size() == 1 && is_integer(options[0]))) {
+        const int decision_time_ms =
+            options.empty() ? 1000 : std::stoi(options[0]);
+        Htp_engine engine(1.41, std::chrono::milliseconds(decision_time_ms),
+                          is_parallelized);
+        engine.run(std::cin, std::cout);
+        return 0;
+      }
+    }
+    if ((arguments.size() == 2 || arguments.size() == 3) &&
+        arguments[0] == "--server" && is_integer(arguments[1]) &&
+        (arguments.size() == 2 || is_integer(arguments[2]))) {
+      const unsigned int thread_count =
+          arguments.size() == 3
+              ? static_cast<unsigned int>(std::stoi(arguments[2]))
+              : std::max(1u, std::thread::hardware_concurrency());
+      Analysis_server server(std::stoi(arguments[1]), thread_count);
+      server.run();
+      return 0;
+    }
+    if (arguments.size() >= 4 && arguments.size() <= 6 &&
+        arguments[0] == "--batch" && is_integer(arguments[3]) &&
+        (arguments.size() < 5 || is_integer(arguments[4])) &&
+        (arguments.size() < 6 || is_integer(arguments[5]))) {
+      const std::size_t max_child_count =
+          arguments.size() >= 5
+              ? static_cast<std::size_t>(std::stoi(arguments[4]))
+              : 5;
+      const unsigned int thread_count =
+          arguments.size() == 6
+              ? static_cast<unsigned int>(std::stoi(arguments[5]))
+              : std::max(1u, std::thread::hardware_concurrency());
+      const auto start_time = std::chrono::steady_clock::now();
+      const std::size_t position_count = run_batch_analysis(
+          arguments[1], arguments[2],
+          std::chrono::milliseconds(std::stoi(arguments[3])), max_child_count,
+          thread_count);
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start_time;
+      std::cout << "Analysed " << position_count << " positions in "
+                << elapsed.count() << " s with " << thread_count
+                << " threads into " << arguments[2] << ".\n";
+      return 0;
+    }
+  } catch (const std::exception& e) {
+    std::cout << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  print_command_line_usage();
+  return 1;
+}
+
 void print_welcome_ascii_art() {
   std::cout << R"(
 
@@ -300,7 +515,7 @@ This implementation of MCTS consists of four main phases:
 
 This process is repeated until the computational budget (based on time) is exhausted. The agent then selects the move that leads to the most promising child node.
 
-In this implementation, the MCTS agent also supports parallel simulations by running multiple threads, each executing an MCTS iteration. The non-parallelised agent can run in verbose mode, outputting detailed information about each MCTS iteration, which can be a valuable tool for understanding the decision-making process of the AI.
+In this implementation, the MCTS agent also supports parallel simulations by running multiple threads, each executing an MCTS iteration. The agent can also run in verbose mode, outputting detailed information about each MCTS iteration, which can be a valuable tool for understanding the decision-making process of the AI.
 
 It should be noted that while MCTS does incorporate randomness (through the simulation phase), it is not a purely random algorithm. It uses the results of previous iterations to make informed decisions, and over time it builds a more accurate representation of the search space.
 
@@ -5,6 +5,8 @@
 #include <iostream>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "game.h"
 
@@ -29,7 +31,7 @@ bool is_integer(const std::string& s);
  * @param prompt The string to display to the user.
  * @return Lowercase 'y' or 'n' based on user's response.
  */
-char get_yes_or_no_response();
+char get_yes_or_no_response(const std::string& prompt);
 
 /**
  * @brief Check if a value is within bounds.
@@ -75,13 +77,24 @@ double get_parameter_within_bounds<double>(const std::string& prompt,
                                            double lower_bound,
                                            double upper_bound);
 
+/**
+ * @brief Prompts the user for the optional search enhancements of an MCTS
+ * player, such as playout cutoffs with a static evaluation, prior knowledge
+ * of the moves, progressive widening, the selection policy and the final move
+ * criterion with its search extension.
+ *
+ * @param mcts_player The player to configure.
+ */
+void configure_advanced_search_options(Mcts_player& mcts_player);
+
 /**
  * @brief Creates a Monte Carlo Tree Search (MCTS) player with custom
  * parameters.
  *
  * This function prompts the user for various parameters to initialize the MCTS
  * agent, such as maximum decision time, exploration constant, parallelization,
- * and verbosity.
+ * verbosity, advanced search options, an opening book and binary search
+ * tracing.
  *
  * @param agent_prompt The string used to indicate the agent being initialized.
  * @return A unique pointer to the MCTS agent.
@@ -99,6 +112,20 @@ std::unique_ptr<Mcts_player> create_mcts_agent(const std::string& agent_prompt);
  */
 void countdown(int seconds);
 
+/**
+ * @brief Asks the user whether the game is played with the swap rule.
+ *
+ * @return True if the second player may swap after the first move.
+ */
+bool ask_for_swap_rule();
+
+/**
+ * @brief Offers to append the record of a finished game to an SGF file.
+ *
+ * @param game The finished game.
+ */
+void offer_to_save_game_record(const Game& game);
+
 /**
  * @brief Start a game against an MCTS agent.
  *
@@ -133,6 +160,33 @@ void start_human_arena();
  */
 void run_console_interface();
 
+/**
+ * @brief Prints the usage of the command-line modes.
+ */
+void print_command_line_usage();
+
+/**
+ * @brief Runs a non-interactive mode selected by command-line arguments.
+ *
+ * Supported modes:
+ * - `--build-book <file> <board size> <plies> <milliseconds per position>
+ *   [--parallel]` builds an opening book with Opening_book::build().
+ * - `--htp [<milliseconds per move>] [--parallel]` runs an Htp_engine on the
+ *   standard input and output, with 1000 milliseconds per move by default.
+ * - `--server <port> [<threads>]` runs an Analysis_server on the local port,
+ *   with one search thread per hardware thread by default.
+ * - `--batch <input> <output> <milliseconds per position> [<top k>]
+ *   [<threads>]` analyses a file of positions with run_batch_analysis(),
+ *   reporting the 5 best moves of each with one thread per hardware
+ *   thread by default.
+ *
+ * Prints the usage if the arguments are not recognized.
+ *
+ * @param arguments The command-line arguments without the programme name.
+ * @return The exit code of the programme.
+ */
+int run_command_line(const std::vector<std::string>& arguments);
+
 /**
  * @brief Prints welcome message in ASCII art.
  */
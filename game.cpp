@@ -3,31 +3,80 @@
 #include <iostream>
 
 Game::Game(int board_size, std::unique_ptr<Player> player1,
-           std::unique_ptr<Player> player_2)
-    : board(board_size), current_player_index(0) {
+           std::unique_ptr<Player> player_2, bool is_swap_rule_enabled,
+           bool is_rendering)
+    : board(board_size),
+      current_player_index(0),
+      record(board_size),
+      is_swap_rule_enabled(is_swap_rule_enabled),
+      is_rendering(is_rendering) {
   players[0] = std::move(player1);
   players[1] = std::move(player_2);
+  for (auto& player : players) {
+    player->set_is_rendering(is_rendering);
+  }
 }
 
 void Game::play() {
-  while (board.check_winner() == Cell_state::Empty) {
+  // Only the stone just placed can win, so the result is checked from it
+  Cell_state winning_player = Cell_state::Empty;
+  while (winning_player == Cell_state::Empty) {
     Cell_state current_player =
         current_player_index == 0 ? Cell_state::Blue : Cell_state::Red;
-    std::cout << "\nPlayer " << current_player << "'s turn:" << std::endl;
-    board.display_board(std::cout);
+    if (is_rendering) {
+      std::cout << "\nPlayer " << current_player << "'s turn:" << std::endl;
+      board.display_board(std::cout);
+    }
     std::pair<int, int> chosen_move =
         players[current_player_index]->choose_move(board, current_player);
-    int chosen_row = chosen_move.first + 1;
-    char chosen_col = chosen_move.second + 'a';
-    std::cout << "\nPlayer " << current_player << " chose move: " << chosen_row
-              << " " << chosen_col << std::endl;
-    board.make_move(chosen_move.first, chosen_move.second, current_player);
+    if (is_rendering) {
+      int chosen_row = chosen_move.first + 1;
+      char chosen_col = chosen_move.second + 'a';
+      std::cout << "\nPlayer " << current_player
+                << " chose move: " << chosen_row << " " << chosen_col
+                << std::endl;
+    }
+    winning_player =
+        board.make_move(chosen_move.first, chosen_move.second, current_player);
+    record.add_move(current_player, chosen_move);
     switch_player();
+    if (is_swap_rule_enabled && record.get_moves().size() == 1 &&
+        winning_player == Cell_state::Empty) {
+      offer_swap(chosen_move);
+    }
+  }
+  if (is_rendering) {
+    board.display_board(std::cout);
+    std::cout << "Player " << winning_player << " wins!" << std::endl;
+  }
+  record.set_winner(winning_player);
+}
+
+const Game_record& Game::get_record() const { return record; }
+
+void Game::offer_swap(const std::pair<int, int>& first_move) {
+  if (is_rendering) {
+    std::cout << "\nPlayer " << Cell_state::Red << " may swap:" << std::endl;
+    board.display_board(std::cout);
+  }
+  if (!players[1]->choose_swap(board, first_move, Cell_state::Red)) {
+    if (is_rendering) {
+      std::cout << "\nPlayer " << Cell_state::Red << " does not swap."
+                << std::endl;
+    }
+    return;
+  }
+  // The stone changes colour and is mirrored, so that it plays the same role
+  // for the swapping player as it did for the first player.
+  board.clear();
+  board.make_move(first_move.second, first_move.first, Cell_state::Red);
+  record.add_swap(Cell_state::Red);
+  if (is_rendering) {
+    std::cout << "\nPlayer " << Cell_state::Red << " swaps: the stone moves to "
+              << first_move.second + 1 << " "
+              << static_cast<char>(first_move.first + 'a') << "." << std::endl;
   }
-  board.display_board(std::cout);
-  Cell_state winning_player =
-      (current_player_index == 0) ? Cell_state::Red : Cell_state::Blue;
-  std::cout << "Player " << winning_player << " wins!" << std::endl;
+  switch_player();
 }
 
 void Game::switch_player() { current_player_index = 1 - current_player_index; }
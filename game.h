@@ -5,6 +5,7 @@
 
 #include "board.h"
 #include "cell_state.h"
+#include "game_record.h"
 #include "player.h"
 
 /**
@@ -27,31 +28,59 @@ class Game {
    * @param board_size The size of the game board.
    * @param player1 Unique pointer to the first player.
    * @param player2 Unique pointer to the second player.
+   * @param is_swap_rule_enabled Whether the second player may take over the
+   * first move instead of replying to it.
+   * @param is_rendering Whether the turns, the board before each move and the
+   * result are printed. Headless games, e.g. of self-play, print nothing,
+   * and their players are told so with Player::set_is_rendering(); only the
+   * logs of verbose players remain.
    */
   Game(int board_size, std::unique_ptr<Player> player_1,
-       std::unique_ptr<Player> player_2);
+       std::unique_ptr<Player> player_2, bool is_swap_rule_enabled = false,
+       bool is_rendering = true);
 
   /**
    * @brief Starts and manages the Hex game.
    *
    * This function contains the main game loop. It continues until a player
-   * wins, i.e., when the board's check_winner() function no longer returns
-   * Cell_state::Empty. On each iteration of the loop, it:
-   *   - Displays the current player's turn,
-   *   - Displays the current state of the board,
+   * wins, i.e., when Board::make_move() reports that the stone just placed
+   * connects its player's edges. On each iteration of the loop, it:
+   *   - Displays the current player's turn and the board, if rendering,
    *   - Asks the current player to choose a move,
    *   - Makes the chosen move on the board,
    *   - Switches to the other player.
+   * With the swap rule, the second player is first asked whether to swap. A
+   * swap replaces the first stone by a stone of the second player on the
+   * mirrored cell, and the first player moves again.
    * Once a player wins, it displays the final state of the board and the
-   * winner.
+   * winner, if rendering. Every move and the winner are kept in the game
+   * record.
    */
   void play();
 
+  /**
+   * @brief Getter for the record of the moves played so far and the winner.
+   *
+   * @return The game record, which can be saved as SGF.
+   */
+  const Game_record& get_record() const;
+
  private:
   Board board;  ///< The Hex game board.
   std::unique_ptr<Player>
       players[2];            ///< Array of unique pointers to the two players.
   int current_player_index;  ///< Index of the current player.
+  Game_record record;        ///< The moves played so far and the winner.
+  bool is_swap_rule_enabled;  ///< Whether the swap rule is played.
+  bool is_rendering;          ///< Whether the game is printed.
+
+  /**
+   * @brief Offers the swap to the second player after the first move, and
+   * applies it if accepted.
+   *
+   * @param first_move The first move of the game.
+   */
+  void offer_swap(const std::pair<int, int>& first_move);
 
   /**
    * @brief Switches the current player.
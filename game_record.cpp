@@ -0,0 +1,257 @@
+#include "game_record.h"
+
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Returns the SGF colour letter of a player.
+ */
+char to_sgf_color(Cell_state player) {
+  return player == Cell_state::Blue ? 'B' : 'W';
+}
+
+// The columns are the letters a to z, so no board has more rows than this
+const int max_cell_row = 26;
+
+}  // namespace
+
+std::string format_cell(const std::pair<int, int>& move) {
+  return static_cast<char>('a' + move.second) + std::to_string(move.first + 1);
+}
+
+std::pair<int, int> parse_cell(const std::string& value) {
+  if (value.size() < 2 || value[0] < 'a' || value[0] > 'z') {
+    throw std::invalid_argument("Invalid move '" + value + "'.");
+  }
+  int row = 0;
+  for (std::size_t i = 1; i < value.size(); ++i) {
+    if (!std::isdigit(static_cast<unsigned char>(value[i]))) {
+      throw std::invalid_argument("Invalid move '" + value + "'.");
+    }
+    row = row * 10 + (value[i] - '0');
+    // Stopping here also keeps the accumulated row from overflowing
+    if (row > max_cell_row) {
+      throw std::invalid_argument("Invalid move '" + value + "'.");
+    }
+  }
+  return std::make_pair(row - 1, value[0] - 'a');
+}
+
+Game_record::Game_record(int board_size) : board_size(board_size) {}
+
+void Game_record::add_move(Cell_state player,
+                           const std::pair<int, int>& move) {
+  moves.push_back(Recorded_move{player, move});
+}
+
+void Game_record::add_swap(Cell_state player) {
+  if (moves.size() != 1) {
+    throw std::logic_error("The swap rule only applies to the second move.");
+  }
+  const std::pair<int, int>& first_move = moves.front().move;
+  moves.push_back(Recorded_move{
+      player, std::make_pair(first_move.second, first_move.first), true});
+}
+
+void Game_record::remove_last_move() {
+  if (moves.empty()) {
+    throw std::logic_error("There is no move to remove.");
+  }
+  moves.pop_back();
+  winner = Cell_state::Empty;
+}
+
+void Game_record::set_winner(Cell_state winning_player) {
+  winner = winning_player;
+}
+
+int Game_record::get_board_size() const { return board_size; }
+
+const std::vector<Recorded_move>& Game_record::get_moves() const {
+  return moves;
+}
+
+Cell_state Game_record::get_winner() const { return winner; }
+
+Cell_state Game_record::get_player_to_move() const {
+  return moves.empty() || moves.back().player == Cell_state::Red
+             ? Cell_state::Blue
+             : Cell_state::Red;
+}
+
+Board Game_record::board_at_ply(int ply) const {
+  if (ply < 0 || ply > static_cast<int>(moves.size())) {
+    throw std::out_of_range("Ply " + std::to_string(ply) +
+                            " is outside of the recorded game.");
+  }
+  Board board(board_size);
+  for (int i = 0; i < ply; ++i) {
+    // A swap replaces the only stone on the board by the mirrored one
+    if (moves[i].is_swap) {
+      board.clear();
+    }
+    board.make_move(moves[i].move.first, moves[i].move.second,
+                    moves[i].player);
+  }
+  return board;
+}
+
+void Game_record::write_sgf(std::ostream& os) const {
+  os << "(;FF[4]GM[11]SZ[" << board_size << "]";
+  if (winner != Cell_state::Empty) {
+    os << "RE[" << to_sgf_color(winner) << "+]";
+  }
+  for (const auto& recorded_move : moves) {
+    os << ';' << to_sgf_color(recorded_move.player) << '['
+       << (recorded_move.is_swap ? "swap-pieces"
+                                 : format_cell(recorded_move.move))
+       << ']';
+  }
+  os << ')';
+}
+
+Game_record Game_record::parse_sgf(const std::string& sgf) {
+  int parsed_board_size = 0;
+  Cell_state parsed_winner = Cell_state::Empty;
+  std::vector<Recorded_move> parsed_moves;
+  std::string identifier;
+  std::string value;
+  int depth = 0;
+  // A letter after a property value starts a new property identifier
+  bool is_after_value = false;
+  // Only the first variation of every branching point is followed
+  bool is_main_line_done = false;
+  bool has_game_tree = false;
+
+  std::size_t position = 0;
+  while (position < sgf.size()) {
+    char character = sgf[position++];
+    if (character == '(') {
+      ++depth;
+      has_game_tree = true;
+    } else if (character == ')') {
+      if (--depth < 0) {
+        throw std::invalid_argument("Unbalanced parentheses in SGF.");
+      }
+      is_main_line_done = true;
+      if (depth == 0) break;
+    } else if (character == ';') {
+      identifier.clear();
+      is_after_value = false;
+    } else if (std::isupper(static_cast<unsigned char>(character))) {
+      if (is_after_value) {
+        identifier.clear();
+        is_after_value = false;
+      }
+      identifier += character;
+    } else if (std::islower(static_cast<unsigned char>(character))) {
+      // Lowercase letters of old-style identifiers (e.g. "GaMe") are ignored
+    } else if (character == '[') {
+      is_after_value = true;
+      value.clear();
+      while (position < sgf.size() && sgf[position] != ']') {
+        if (sgf[position] == '\\' && position + 1 < sgf.size()) ++position;
+        value += sgf[position++];
+      }
+      if (position++ >= sgf.size()) {
+        throw std::invalid_argument("Unterminated SGF property value.");
+      }
+      if (is_main_line_done) continue;
+      if (identifier == "SZ") {
+        parsed_board_size = std::atoi(value.c_str());
+      } else if (identifier == "GM") {
+        if (value != "11") {
+          throw std::invalid_argument("The SGF record is not a Hex game.");
+        }
+      } else if (identifier == "RE") {
+        if (!value.empty() && (value[0] == 'B' || value[0] == 'W')) {
+          parsed_winner = value[0] == 'B' ? Cell_state::Blue : Cell_state::Red;
+        }
+      } else if (identifier == "B" || identifier == "W") {
+        Cell_state player =
+            identifier == "B" ? Cell_state::Blue : Cell_state::Red;
+        if (value == "swap-pieces") {
+          if (parsed_moves.size() != 1) {
+            throw std::invalid_argument("SGF swap is not the second move.");
+          }
+          const std::pair<int, int>& first_move = parsed_moves.front().move;
+          parsed_moves.push_back(Recorded_move{
+              player, std::make_pair(first_move.second, first_move.first),
+              true});
+        } else {
+          parsed_moves.push_back(
+              Recorded_move{player, parse_cell(value)});
+        }
+      }
+    } else if (!std::isspace(static_cast<unsigned char>(character))) {
+      throw std::invalid_argument(std::string("Unexpected character '") +
+                                  character + "' in SGF.");
+    }
+  }
+  if (!has_game_tree || depth != 0) {
+    throw std::invalid_argument("Incomplete SGF game tree.");
+  }
+  if (parsed_board_size < 2) {
+    throw std::invalid_argument("The SGF record has no valid board size.");
+  }
+  Game_record record(parsed_board_size);
+  for (const auto& recorded_move : parsed_moves) {
+    if (recorded_move.move.first < 0 ||
+        recorded_move.move.first >= parsed_board_size ||
+        recorded_move.move.second >= parsed_board_size) {
+      throw std::invalid_argument("SGF move outside of the board.");
+    }
+    if (recorded_move.is_swap) {
+      record.add_swap(recorded_move.player);
+    } else {
+      record.add_move(recorded_move.player, recorded_move.move);
+    }
+  }
+  record.set_winner(parsed_winner);
+  return record;
+}
+
+Sgf_writer::Sgf_writer(std::ostream& os) : os(os) {}
+
+void Sgf_writer::write(const Game_record& record) {
+  record.write_sgf(os);
+  os << '\n';
+  ++game_count;
+}
+
+long long Sgf_writer::get_game_count() const { return game_count; }
+
+Sgf_reader::Sgf_reader(std::istream& is) : is(is) {}
+
+bool Sgf_reader::read_next(Game_record& record) {
+  game_tree.clear();
+  char character;
+  // Skip anything before the next game tree
+  while (is.get(character) && character != '(') {
+  }
+  if (!is) return false;
+  game_tree += character;
+  int depth = 1;
+  bool is_in_value = false;
+  while (depth > 0 && is.get(character)) {
+    game_tree += character;
+    if (is_in_value) {
+      if (character == '\\' && is.get(character)) {
+        game_tree += character;
+      } else if (character == ']') {
+        is_in_value = false;
+      }
+    } else if (character == '[') {
+      is_in_value = true;
+    } else if (character == '(') {
+      ++depth;
+    } else if (character == ')') {
+      --depth;
+    }
+  }
+  record = Game_record::parse_sgf(game_tree);
+  return true;
+}
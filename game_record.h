@@ -0,0 +1,226 @@
+#ifndef GAME_RECORD_H
+#define GAME_RECORD_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "cell_state.h"
+
+/**
+ * @brief Converts a move to the notation of the displayed board, i.e. the
+ * column letter followed by the 1-based row number such as "f6". The
+ * notation is shared by SGF and the Hex Text Protocol.
+ *
+ * @param move The move, row first, column second.
+ */
+std::string format_cell(const std::pair<int, int>& move);
+
+/**
+ * @brief Parses a cell such as "f6" into a move, row first.
+ *
+ * @param value The cell in the notation of format_cell().
+ * @return The move, which may lie outside of the board.
+ * @throws std::invalid_argument if the value is not a cell or its row is
+ * beyond 26, the largest board that the column letters can describe.
+ */
+std::pair<int, int> parse_cell(const std::string& value);
+
+/**
+ * @struct Recorded_move
+ * @brief A single move of a recorded game.
+ */
+struct Recorded_move {
+  Cell_state player;         ///< The player who made the move.
+  std::pair<int, int> move;  ///< The move, row first, column second.
+  /// True if the move applied the swap rule. The move is then the mirrored
+  /// cell of the first move, where the swapping player's stone now stands.
+  bool is_swap = false;
+};
+
+/**
+ * @class Game_record
+ *
+ * @brief The move history of a Hex game, with load and save support for the
+ * Hex variant of the Smart Game Format (SGF).
+ *
+ * A record written by this class looks like
+ * `(;FF[4]GM[11]SZ[11]RE[B+];B[f6];W[e7])`, i.e. the SGF game number of Hex
+ * (11), the board size, the result and one node per move. Blue, who moves
+ * first, is written as B and Red as W. Cells are written as the column letter
+ * followed by the 1-based row number, as they are labelled on the displayed
+ * board, so boards of up to 26 columns can be recorded. A swap is written as
+ * the move `swap-pieces`.
+ *
+ * The parser is a single pass over the characters without regular
+ * expressions or intermediate property maps. It accepts any well-formed game
+ * tree, skipping properties it does not know, but follows only the main line
+ * of variations.
+ */
+class Game_record {
+ public:
+  /**
+   * @brief Constructs an empty record of a game.
+   *
+   * @param board_size The size of the board the game is played on.
+   */
+  explicit Game_record(int board_size);
+
+  /**
+   * @brief Appends a move to the record.
+   *
+   * @param player The player who made the move.
+   * @param move The move, row first, column second.
+   */
+  void add_move(Cell_state player, const std::pair<int, int>& move);
+
+  /**
+   * @brief Appends the application of the swap rule to the record.
+   *
+   * @param player The player who swapped.
+   * @throws std::logic_error if the record does not hold exactly one move.
+   */
+  void add_swap(Cell_state player);
+
+  /**
+   * @brief Removes the last move from the record, e.g. to take it back. The
+   * game is unfinished afterwards.
+   *
+   * @throws std::logic_error if the record holds no move.
+   */
+  void remove_last_move();
+
+  /**
+   * @brief Sets the winner of the game.
+   *
+   * @param winning_player The winner, or Cell_state::Empty if the game is
+   * unfinished.
+   */
+  void set_winner(Cell_state winning_player);
+
+  /**
+   * @brief Getter for the board size of the game.
+   */
+  int get_board_size() const;
+
+  /**
+   * @brief Getter for the moves of the game in the order they were made.
+   */
+  const std::vector<Recorded_move>& get_moves() const;
+
+  /**
+   * @brief Getter for the winner of the game, Cell_state::Empty if unknown.
+   */
+  Cell_state get_winner() const;
+
+  /**
+   * @brief Returns the player to move after the recorded moves: Blue in an
+   * empty game, else the opponent of the last mover.
+   */
+  Cell_state get_player_to_move() const;
+
+  /**
+   * @brief Reconstructs the board after a given number of moves.
+   *
+   * @param ply The number of moves to replay, between 0 and the number of
+   * recorded moves.
+   * @return The board after the first `ply` moves.
+   * @throws std::out_of_range if ply is outside the recorded range.
+   * @throws std::invalid_argument if a recorded move is illegal.
+   */
+  Board board_at_ply(int ply) const;
+
+  /**
+   * @brief Writes the record as a single-line SGF game tree.
+   *
+   * @param os The output stream to write to.
+   */
+  void write_sgf(std::ostream& os) const;
+
+  /**
+   * @brief Parses a single SGF game tree.
+   *
+   * @param sgf The text of the game tree.
+   * @return The parsed record.
+   * @throws std::invalid_argument if the text is not a valid Hex game record.
+   */
+  static Game_record parse_sgf(const std::string& sgf);
+
+ private:
+  int board_size;
+  std::vector<Recorded_move> moves;
+  Cell_state winner = Cell_state::Empty;
+};
+
+/**
+ * @class Sgf_writer
+ *
+ * @brief Streams game records into an SGF collection, one game tree per line.
+ *
+ * Intended for batch self-play: each game is written as soon as it finishes,
+ * so the archive never has to be held in memory and a partially written file
+ * remains a valid collection up to its last complete line.
+ */
+class Sgf_writer {
+ public:
+  /**
+   * @brief Constructs a writer appending to an output stream.
+   *
+   * @param os The stream to write the collection to. It must outlive the
+   * writer.
+   */
+  explicit Sgf_writer(std::ostream& os);
+
+  /**
+   * @brief Writes a game record as the next game tree of the collection.
+   *
+   * @param record The record to write.
+   */
+  void write(const Game_record& record);
+
+  /**
+   * @brief Returns the number of games written so far.
+   */
+  long long get_game_count() const;
+
+ private:
+  std::ostream& os;
+  long long game_count = 0;
+};
+
+/**
+ * @class Sgf_reader
+ *
+ * @brief Reads the game trees of an SGF collection one at a time.
+ *
+ * Only the text of the current game tree is buffered, so arbitrarily large
+ * archives can be replayed in constant memory.
+ */
+class Sgf_reader {
+ public:
+  /**
+   * @brief Constructs a reader over an input stream.
+   *
+   * @param is The stream containing the collection. It must outlive the
+   * reader.
+   */
+  explicit Sgf_reader(std::istream& is);
+
+  /**
+   * @brief Reads the next game of the collection.
+   *
+   * @param record Receives the next game record.
+   * @return True if a game was read, false at the end of the collection.
+   * @throws std::invalid_argument if the next game tree is malformed.
+   */
+  bool read_next(Game_record& record);
+
+ private:
+  std::istream& is;
+  std::string game_tree;
+};
+
+#endif  // GAME_RECORD_H
@@ -0,0 +1,312 @@
+#include "htp_engine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "logger.h"
+
+namespace {
+
+const int default_board_size = 11;
+// Cells are labelled with a single letter per column
+const int max_board_size = 26;
+// The shortest search when the time left is running out
+const std::chrono::milliseconds min_decision_time(10);
+// The most time left accepted from time_left, a week, in seconds
+const long long max_time_left_seconds = 7 * 24 * 60 * 60;
+
+std::string to_lower(std::string text) {
+  std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return text;
+}
+
+bool is_number(const std::string& text) {
+  return !text.empty() && std::all_of(text.begin(), text.end(),
+                                      [](unsigned char c) {
+                                        return std::isdigit(c) != 0;
+                                      });
+}
+
+/**
+ * @brief Parses a decimal number without a sign, or returns -1 if the text is
+ * not one or the number exceeds the maximum.
+ */
+long long parse_number(const std::string& text, long long max_value) {
+  if (!is_number(text)) return -1;
+  long long number = 0;
+  for (char digit : text) {
+    // Checked per digit, so the number never overflows
+    number = 10 * number + (digit - '0');
+    if (number > max_value) return -1;
+  }
+  return number;
+}
+
+void check_argument_count(const std::vector<std::string>& arguments,
+                          std::size_t min_count, std::size_t max_count) {
+  if (arguments.size() < min_count || arguments.size() > max_count) {
+    throw std::invalid_argument("wrong number of arguments");
+  }
+}
+
+/**
+ * @brief Parses an HTP colour: black for Blue, who moves first, and white for
+ * Red. The colour names of this program are accepted as well.
+ */
+Cell_state parse_color(const std::string& argument) {
+  const std::string color = to_lower(argument);
+  if (color == "b" || color == "black" || color == "blue") {
+    return Cell_state::Blue;
+  }
+  if (color == "w" || color == "white" || color == "r" || color == "red") {
+    return Cell_state::Red;
+  }
+  throw std::invalid_argument("invalid color '" + argument + "'");
+}
+
+}  // namespace
+
+Htp_engine::Htp_engine(double exploration_factor,
+                       std::chrono::milliseconds max_decision_time,
+                       bool is_parallelized)
+    : max_decision_time(max_decision_time),
+      agent(exploration_factor, max_decision_time, is_parallelized),
+      board(default_board_size),
+      record(default_board_size) {
+  // Only protocol responses may reach the controller
+  auto logger = std::make_shared<Logger>(false);
+  logger->set_output_stream(std::cerr);
+  agent.set_logger(logger);
+}
+
+void Htp_engine::run(std::istream& is, std::ostream& os) {
+  std::string line;
+  while (!is_quitting && std::getline(is, line)) {
+    // Drop comments and control characters, which HTP ignores
+    line = line.substr(0, line.find('#'));
+    for (char& c : line) {
+      if (c == '\t') {
+        c = ' ';
+      } else if (std::iscntrl(static_cast<unsigned char>(c))) {
+        c = ' ';
+      }
+    }
+    std::istringstream tokens(line);
+    std::vector<std::string> arguments;
+    std::string token;
+    while (tokens >> token) {
+      arguments.push_back(token);
+    }
+    if (arguments.empty()) continue;
+    std::string id;
+    if (is_number(arguments.front())) {
+      id = arguments.front();
+      arguments.erase(arguments.begin());
+    }
+    if (arguments.empty()) continue;
+    const std::string command = arguments.front();
+    arguments.erase(arguments.begin());
+    try {
+      const std::string result = execute(command, arguments);
+      os << '=' << id << (result.empty() ? "" : " " + result) << "\n\n";
+    } catch (const std::exception& e) {
+      os << '?' << id << ' ' << e.what() << "\n\n";
+    }
+    os.flush();
+  }
+}
+
+std::string Htp_engine::execute(const std::string& name,
+                                const std::vector<std::string>& arguments) {
+  const auto& handlers = get_command_handlers();
+  auto handler = handlers.find(name);
+  if (handler == handlers.end()) {
+    throw std::invalid_argument("unknown command");
+  }
+  return (this->*(handler->second))(arguments);
+}
+
+bool Htp_engine::is_quit_requested() const { return is_quitting; }
+
+const std::map<std::string, Htp_engine::Command_handler>&
+Htp_engine::get_command_handlers() {
+  static const std::map<std::string, Command_handler> handlers = {
+      {"protocol_version", &Htp_engine::protocol_version},
+      {"name", &Htp_engine::name},
+      {"version", &Htp_engine::version},
+      {"known_command", &Htp_engine::known_command},
+      {"list_commands", &Htp_engine::list_commands},
+      {"quit", &Htp_engine::quit},
+      {"boardsize", &Htp_engine::boardsize},
+      {"clear_board", &Htp_engine::clear_board},
+      {"play", &Htp_engine::play},
+      {"genmove", &Htp_engine::genmove},
+      {"undo", &Htp_engine::undo},
+      {"time_left", &Htp_engine::time_left},
+      {"showboard", &Htp_engine::showboard}};
+  return handlers;
+}
+
+std::chrono::milliseconds Htp_engine::get_decision_time(
+    Cell_state player) const {
+  auto remaining_time = remaining_times.find(player);
+  if (remaining_time == remaining_times.end()) {
+    return max_decision_time;
+  }
+  // The player makes about every second move on the empty cells, and one
+  // share of the time is kept in reserve
+  const int empty_cell_count =
+      static_cast<int>(board.get_valid_moves().size());
+  const int expected_move_count = (empty_cell_count + 1) / 2 + 1;
+  return std::max(min_decision_time,
+                  std::min(max_decision_time,
+                           remaining_time->second / expected_move_count));
+}
+
+std::string Htp_engine::protocol_version(
+    const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  return "2";
+}
+
+std::string Htp_engine::name(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  return "MCTS-Hex";
+}
+
+std::string Htp_engine::version(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  return "1.0";
+}
+
+std::string Htp_engine::known_command(
+    const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 1, 1);
+  return get_command_handlers().count(arguments[0]) ? "true" : "false";
+}
+
+std::string Htp_engine::list_commands(
+    const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  std::string commands;
+  for (const auto& handler : get_command_handlers()) {
+    commands += (commands.empty() ? "" : "\n") + handler.first;
+  }
+  return commands;
+}
+
+std::string Htp_engine::quit(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  is_quitting = true;
+  return "";
+}
+
+std::string Htp_engine::boardsize(const std::vector<std::string>& arguments) {
+  // HexGui sends the number of columns and rows, which must be equal here
+  check_argument_count(arguments, 1, 2);
+  const int size =
+      static_cast<int>(parse_number(arguments[0], max_board_size));
+  if (size < 2 || (arguments.size() == 2 && arguments[1] != arguments[0])) {
+    throw std::invalid_argument("unacceptable size");
+  }
+  board = Board(size);
+  record = Game_record(size);
+  remaining_times.clear();
+  return "";
+}
+
+std::string Htp_engine::clear_board(
+    const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  board.clear();
+  record = Game_record(board.get_board_size());
+  remaining_times.clear();
+  return "";
+}
+
+std::string Htp_engine::play(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 2, 2);
+  const Cell_state player = parse_color(arguments[0]);
+  const std::string cell = to_lower(arguments[1]);
+  if (record.get_winner() != Cell_state::Empty) {
+    throw std::invalid_argument("game is over");
+  }
+  if (cell == "swap-pieces") {
+    // Only the second player may take over the first stone
+    if (record.get_moves().size() != 1 ||
+        record.get_moves().front().player == player) {
+      throw std::invalid_argument("illegal move");
+    }
+    record.add_swap(player);
+    const std::pair<int, int>& swapped_move = record.get_moves().back().move;
+    board.clear();
+    board.make_move(swapped_move.first, swapped_move.second, player);
+    return "";
+  }
+  const std::pair<int, int> move = parse_cell(cell);
+  if (!board.is_valid_move(move.first, move.second)) {
+    throw std::invalid_argument("illegal move");
+  }
+  const Cell_state winner = board.make_move(move.first, move.second, player);
+  record.add_move(player, move);
+  record.set_winner(winner);
+  return "";
+}
+
+std::string Htp_engine::genmove(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 1, 1);
+  const Cell_state player = parse_color(arguments[0]);
+  if (record.get_winner() != Cell_state::Empty) {
+    throw std::invalid_argument("game is over");
+  }
+  agent.set_max_decision_time(get_decision_time(player));
+  const std::pair<int, int> move = agent.choose_move(board, player);
+  const Cell_state winner = board.make_move(move.first, move.second, player);
+  record.add_move(player, move);
+  record.set_winner(winner);
+  return format_cell(move);
+}
+
+std::string Htp_engine::undo(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  if (record.get_moves().empty()) {
+    throw std::invalid_argument("cannot undo");
+  }
+  record.remove_last_move();
+  board = record.board_at_ply(static_cast<int>(record.get_moves().size()));
+  return "";
+}
+
+std::string Htp_engine::time_left(const std::vector<std::string>& arguments) {
+  // The number of stones of byo-yomi periods does not apply to Hex
+  check_argument_count(arguments, 2, 3);
+  const Cell_state player = parse_color(arguments[0]);
+  const long long seconds = parse_number(arguments[1], max_time_left_seconds);
+  if (seconds < 0) {
+    throw std::invalid_argument("invalid time '" + arguments[1] + "'");
+  }
+  remaining_times[player] = std::chrono::seconds(seconds);
+  return "";
+}
+
+std::string Htp_engine::showboard(const std::vector<std::string>& arguments) {
+  check_argument_count(arguments, 0, 0);
+  std::ostringstream os;
+  board.display_board(os);
+  // An empty line would end the response early
+  std::string display = os.str();
+  display.erase(std::unique(display.begin(), display.end(),
+                            [](char first, char second) {
+                              return first == '\n' && second == '\n';
+                            }),
+                display.end());
+  while (!display.empty() && display.back() == '\n') {
+    display.pop_back();
+  }
+  return display;
+}
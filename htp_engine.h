@@ -0,0 +1,117 @@
+#ifndef HTP_ENGINE_H
+#define HTP_ENGINE_H
+
+#include <chrono>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "board.h"
+#include "cell_state.h"
+#include "game_record.h"
+#include "mcts_agent.h"
+
+/**
+ * @class Htp_engine
+ *
+ * @brief Drives an Mcts_agent with the Hex Text Protocol (HTP), the Hex
+ * dialect of the Go Text Protocol understood by HexGui and tournament
+ * managers.
+ *
+ * Each command is a line `[id] name [arguments]`, answered with
+ * `=[id] result` or `?[id] error message` followed by an empty line. The
+ * supported commands are protocol_version, name, version, known_command,
+ * list_commands, quit, boardsize, clear_board, play, genmove, undo,
+ * time_left and showboard. Black moves first and connects the top and bottom
+ * rows, i.e. black is Cell_state::Blue and white is Cell_state::Red. Cells
+ * are written as on the displayed board, e.g. `f6`, and `play` accepts
+ * `swap-pieces` as the second move.
+ *
+ * The engine keeps one agent for its whole lifetime, so the agent's thread
+ * pool and first-move tables are set up once, and a position searched again,
+ * e.g. after an undo, continues on the agent's tree. Once the controller has
+ * sent time_left for a player, the remaining time is spread over the moves
+ * the player can still expect to make, within the decision time of the
+ * engine.
+ */
+class Htp_engine {
+ public:
+  /**
+   * @brief Constructs an engine on an empty 11x11 board.
+   *
+   * @param exploration_factor The exploration constant of the agent.
+   * @param max_decision_time The longest search per generated move.
+   * @param is_parallelized Determines if playouts are performed in parallel.
+   */
+  Htp_engine(double exploration_factor,
+             std::chrono::milliseconds max_decision_time,
+             bool is_parallelized);
+
+  /**
+   * @brief Answers the commands of an input stream until it ends or the quit
+   * command is received.
+   *
+   * @param is The stream of commands.
+   * @param os The stream the responses are written to. Nothing else is
+   * written to it.
+   */
+  void run(std::istream& is, std::ostream& os);
+
+  /**
+   * @brief Executes a single command.
+   *
+   * @param name The name of the command.
+   * @param arguments The arguments of the command.
+   * @return The result of the command, without the status prefix.
+   * @throws std::invalid_argument if the command is unknown or fails, with
+   * the error message of the response.
+   */
+  std::string execute(const std::string& name,
+                      const std::vector<std::string>& arguments);
+
+  /**
+   * @brief Checks whether the quit command has been executed.
+   */
+  bool is_quit_requested() const;
+
+ private:
+  using Command_handler =
+      std::string (Htp_engine::*)(const std::vector<std::string>&);
+
+  std::chrono::milliseconds max_decision_time;
+  Mcts_agent agent;
+  Board board;
+  Game_record record;
+  // The time left of each player, once the controller has sent time_left
+  std::map<Cell_state, std::chrono::milliseconds> remaining_times;
+  bool is_quitting = false;
+
+  /**
+   * @brief Returns the handlers of the commands, keyed and sorted by name.
+   */
+  static const std::map<std::string, Command_handler>& get_command_handlers();
+
+  /**
+   * @brief Returns the search time for the next move of a player.
+   */
+  std::chrono::milliseconds get_decision_time(Cell_state player) const;
+
+  // Command handlers, which throw std::invalid_argument on failure
+  std::string protocol_version(const std::vector<std::string>& arguments);
+  std::string name(const std::vector<std::string>& arguments);
+  std::string version(const std::vector<std::string>& arguments);
+  std::string known_command(const std::vector<std::string>& arguments);
+  std::string list_commands(const std::vector<std::string>& arguments);
+  std::string quit(const std::vector<std::string>& arguments);
+  std::string boardsize(const std::vector<std::string>& arguments);
+  std::string clear_board(const std::vector<std::string>& arguments);
+  std::string play(const std::vector<std::string>& arguments);
+  std::string genmove(const std::vector<std::string>& arguments);
+  std::string undo(const std::vector<std::string>& arguments);
+  std::string time_left(const std::vector<std::string>& arguments);
+  std::string showboard(const std::vector<std::string>& arguments);
+};
+
+#endif  // HTP_ENGINE_H
@@ -0,0 +1,221 @@
+#include "inferior_cell_analysis.h"
+
+#include <array>
+
+namespace {
+
+// The six neighbour directions in the order they appear around a cell, as in
+// Board
+const std::array<int, 6> ring_offset_x = {-1, -1, 0, 1, 1, 0};
+const std::array<int, 6> ring_offset_y = {0, 1, 1, 0, -1, -1};
+
+/**
+ * @brief Returns the other player.
+ */
+Cell_state get_opponent(Cell_state player) {
+  return player == Cell_state::Blue ? Cell_state::Red : Cell_state::Blue;
+}
+
+/**
+ * @brief Checks whether every two neighbours that a player could connect
+ * through the centre cell are already joined around it by the player's
+ * stones, i.e. the centre cell is redundant for that player.
+ */
+bool is_redundant_for(const std::array<Cell_state, 6>& ring,
+                      Cell_state colour) {
+  for (int first = 0; first < 6; ++first) {
+    if (ring[first] != colour && ring[first] != Cell_state::Empty) continue;
+    for (int second = first + 1; second < 6; ++second) {
+      if (ring[second] != colour && ring[second] != Cell_state::Empty) {
+        continue;
+      }
+      // Walk around the ring from the first to the second neighbour both ways
+      bool is_joined_clockwise = true;
+      for (int index = first + 1; index < second; ++index) {
+        is_joined_clockwise = is_joined_clockwise && ring[index] == colour;
+      }
+      bool is_joined_anticlockwise = true;
+      for (int index = second + 1; index < first + 6; ++index) {
+        is_joined_anticlockwise =
+            is_joined_anticlockwise && ring[index % 6] == colour;
+      }
+      if (!is_joined_clockwise && !is_joined_anticlockwise) return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+Inferior_cell_analysis::Inferior_cell_analysis(const Board& board,
+                                               Cell_state player_to_move)
+    : board_size(board.get_board_size()),
+      player(player_to_move),
+      cells(board_size * board_size),
+      dead_cells(board_size * board_size, 0),
+      captors(board_size * board_size, Cell_state::Empty) {
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      cells[row * board_size + col] = board.get_cell(row, col);
+    }
+  }
+  winning_moves = find_winning_moves(player);
+  opponent_winning_moves = find_winning_moves(get_opponent(player));
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      if (cells[row * board_size + col] == Cell_state::Empty) {
+        dead_cells[row * board_size + col] = is_locally_dead(row, col);
+      }
+    }
+  }
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      const int index = row * board_size + col;
+      if (cells[index] != Cell_state::Empty || dead_cells[index] ||
+          captors[index] != Cell_state::Empty) {
+        continue;
+      }
+      for (int direction = 0; direction < 6; ++direction) {
+        const int neighbour_x = row + ring_offset_x[direction];
+        const int neighbour_y = col + ring_offset_y[direction];
+        if (get_cell_or_edge(neighbour_x, neighbour_y) != Cell_state::Empty) {
+          continue;
+        }
+        const int neighbour_index = neighbour_x * board_size + neighbour_y;
+        if (dead_cells[neighbour_index] ||
+            captors[neighbour_index] != Cell_state::Empty) {
+          continue;
+        }
+        for (Cell_state captor : {Cell_state::Blue, Cell_state::Red}) {
+          if (is_captured_pair(row, col, neighbour_x, neighbour_y, captor)) {
+            captors[index] = captor;
+            captors[neighbour_index] = captor;
+            break;
+          }
+        }
+        if (captors[index] != Cell_state::Empty) break;
+      }
+    }
+  }
+}
+
+std::vector<std::pair<int, int>> Inferior_cell_analysis::get_candidate_moves()
+    const {
+  if (!winning_moves.empty()) return winning_moves;
+  if (opponent_winning_moves.size() == 1) return opponent_winning_moves;
+  std::vector<std::pair<int, int>> candidate_moves;
+  std::vector<std::pair<int, int>> empty_cells;
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      const int index = row * board_size + col;
+      if (cells[index] != Cell_state::Empty) continue;
+      empty_cells.emplace_back(row, col);
+      if (!dead_cells[index] && captors[index] == Cell_state::Empty) {
+        candidate_moves.emplace_back(row, col);
+      }
+    }
+  }
+  return candidate_moves.empty() ? empty_cells : candidate_moves;
+}
+
+Cell_state Inferior_cell_analysis::get_cell_or_edge(int move_x,
+                                                    int move_y) const {
+  // Blue connects the top and bottom rows, Red the left and right columns
+  if (move_x < 0 || move_x >= board_size) return Cell_state::Blue;
+  if (move_y < 0 || move_y >= board_size) return Cell_state::Red;
+  return cells[move_x * board_size + move_y];
+}
+
+bool Inferior_cell_analysis::is_locally_dead(int move_x, int move_y) const {
+  std::array<Cell_state, 6> ring;
+  for (int direction = 0; direction < 6; ++direction) {
+    ring[direction] = get_cell_or_edge(move_x + ring_offset_x[direction],
+                                       move_y + ring_offset_y[direction]);
+  }
+  return is_redundant_for(ring, Cell_state::Blue) &&
+         is_redundant_for(ring, Cell_state::Red);
+}
+
+bool Inferior_cell_analysis::is_captured_pair(int first_x, int first_y,
+                                              int second_x, int second_y,
+                                              Cell_state captor) {
+  Cell_state& first = cells[first_x * board_size + first_y];
+  Cell_state& second = cells[second_x * board_size + second_y];
+  const Cell_state intruder = get_opponent(captor);
+  first = intruder;
+  second = captor;
+  bool is_captured = is_locally_dead(first_x, first_y);
+  if (is_captured) {
+    first = captor;
+    second = intruder;
+    is_captured = is_locally_dead(second_x, second_y);
+  }
+  first = Cell_state::Empty;
+  second = Cell_state::Empty;
+  return is_captured;
+}
+
+std::vector<std::pair<int, int>> Inferior_cell_analysis::find_winning_moves(
+    Cell_state winner) const {
+  // Flood the stones connected to each edge of the winner, then look for
+  // empty cells touching both floods
+  const int edge_count = 2;
+  std::vector<char> is_reached[edge_count] = {
+      std::vector<char>(board_size * board_size, 0),
+      std::vector<char>(board_size * board_size, 0)};
+  std::vector<int> stack;
+  for (int edge = 0; edge < edge_count; ++edge) {
+    const int edge_line = edge == 0 ? 0 : board_size - 1;
+    for (int position = 0; position < board_size; ++position) {
+      const int index = winner == Cell_state::Blue
+                            ? edge_line * board_size + position
+                            : position * board_size + edge_line;
+      if (cells[index] == winner && !is_reached[edge][index]) {
+        is_reached[edge][index] = 1;
+        stack.push_back(index);
+      }
+    }
+    while (!stack.empty()) {
+      const int index = stack.back();
+      stack.pop_back();
+      for (int direction = 0; direction < 6; ++direction) {
+        const int neighbour_x = index / board_size + ring_offset_x[direction];
+        const int neighbour_y = index % board_size + ring_offset_y[direction];
+        if (neighbour_x < 0 || neighbour_x >= board_size || neighbour_y < 0 ||
+            neighbour_y >= board_size) {
+          continue;
+        }
+        const int neighbour_index = neighbour_x * board_size + neighbour_y;
+        if (cells[neighbour_index] == winner &&
+            !is_reached[edge][neighbour_index]) {
+          is_reached[edge][neighbour_index] = 1;
+          stack.push_back(neighbour_index);
+        }
+      }
+    }
+  }
+
+  std::vector<std::pair<int, int>> moves;
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col) {
+      if (cells[row * board_size + col] != Cell_state::Empty) continue;
+      const int line = winner == Cell_state::Blue ? row : col;
+      bool touches_edge[edge_count] = {line == 0, line == board_size - 1};
+      for (int direction = 0; direction < 6; ++direction) {
+        const int neighbour_x = row + ring_offset_x[direction];
+        const int neighbour_y = col + ring_offset_y[direction];
+        if (neighbour_x < 0 || neighbour_x >= board_size || neighbour_y < 0 ||
+            neighbour_y >= board_size) {
+          continue;
+        }
+        for (int edge = 0; edge < edge_count; ++edge) {
+          touches_edge[edge] =
+              touches_edge[edge] ||
+              is_reached[edge][neighbour_x * board_size + neighbour_y];
+        }
+      }
+      if (touches_edge[0] && touches_edge[1]) moves.emplace_back(row, col);
+    }
+  }
+  return moves;
+}
@@ -0,0 +1,89 @@
+#ifndef INFERIOR_CELL_ANALYSIS_H
+#define INFERIOR_CELL_ANALYSIS_H
+
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "cell_state.h"
+
+/**
+ * @class Inferior_cell_analysis
+ *
+ * @brief Finds the empty cells of a position that never need to be played,
+ * so that Mcts_agent does not spend playouts on them.
+ *
+ * The analysis is local and sound, i.e. a pruned move is never better than
+ * every remaining one:
+ * - A cell is dead if its colour cannot matter to either player. This is the
+ *   case when every two neighbours that a player could connect through the
+ *   cell are already joined around it by that player's stones. Off-board
+ *   neighbours count as stones of the player owning that edge. Examples are
+ *   four neighbours of one colour in a row, or three neighbours of one colour
+ *   facing two of the other.
+ * - Two adjacent empty cells are captured by a player if, whichever of them
+ *   the opponent takes, the player takes the other and the opponent's stone
+ *   becomes dead. Filling them with the captor's stones does not change the
+ *   value of the position, so neither player needs to move there.
+ * - If the player to move can win immediately, only the winning moves remain.
+ *   Otherwise, if the opponent threatens to win with a single move, only that
+ *   move remains.
+ *
+ * Intruded bridges are urgent but not forced, so they are left to the prior
+ * values of board_evaluation rather than pruned here.
+ */
+class Inferior_cell_analysis {
+ public:
+  /**
+   * @brief Analyses a position.
+   *
+   * @param board The state of the game board.
+   * @param player_to_move The player whose moves are analysed.
+   */
+  Inferior_cell_analysis(const Board& board, Cell_state player_to_move);
+
+  /**
+   * @brief Returns the moves that remain after pruning.
+   *
+   * @return The forced moves if there are any, else the empty cells that are
+   * neither dead nor captured. Falls back to every empty cell if everything
+   * was pruned.
+   */
+  std::vector<std::pair<int, int>> get_candidate_moves() const;
+
+ private:
+  int board_size;
+  Cell_state player;
+  /// The cells of the board in row-major order. Captures are tested by
+  /// temporarily placing stones, so the analysis works on its own copy.
+  std::vector<Cell_state> cells;
+  std::vector<char> dead_cells;
+  std::vector<Cell_state> captors;
+  std::vector<std::pair<int, int>> winning_moves;
+  std::vector<std::pair<int, int>> opponent_winning_moves;
+
+  /**
+   * @brief Returns a cell, or the owner of the edge for off-board cells.
+   */
+  Cell_state get_cell_or_edge(int move_x, int move_y) const;
+
+  /**
+   * @brief Checks whether the colour of a cell cannot matter to either
+   * player, from its neighbours in the current cells.
+   */
+  bool is_locally_dead(int move_x, int move_y) const;
+
+  /**
+   * @brief Checks whether two adjacent empty cells are captured by a player.
+   */
+  bool is_captured_pair(int first_x, int first_y, int second_x, int second_y,
+                        Cell_state captor);
+
+  /**
+   * @brief Collects the empty cells that connect both edges of a player.
+   */
+  std::vector<std::pair<int, int>> find_winning_moves(
+      Cell_state winner) const;
+};
+
+#endif  // INFERIOR_CELL_ANALYSIS_H
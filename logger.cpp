@@ -1,26 +1,212 @@
 #include "logger.h"
 
-// Initialize static member
-std::shared_ptr<Logger> Logger::logger = nullptr;
+#include <algorithm>
+#include <utility>
 
-std::shared_ptr<Logger> Logger::instance(bool is_verbose) {
-  if (!logger) {
-    logger = std::make_shared<Logger>(is_verbose);
+namespace {
+
+// The messages a thread can queue before waiting for the writer thread
+const std::size_t message_queue_capacity = 1024;
+
+// The writer thread prints the queued messages at least this often
+const std::chrono::milliseconds writer_interval(10);
+
+// The source of Logger::id; 0 marks an empty thread-local cache
+std::atomic<std::uint64_t> next_logger_id(1);
+
+}  // namespace
+
+/**
+ * A bounded single-producer, single-consumer ring of messages. The owning
+ * thread pushes at the tail and the writer thread pops at the head; each
+ * index is written by one side only, so no lock is needed. The indices are
+ * kept on separate cache lines to avoid false sharing. When the owning
+ * thread exits, it retires the queue, and the writer drops it once drained.
+ */
+struct Logger::Message_queue {
+  std::vector<std::string> slots;
+  std::atomic<std::size_t> head{0};  // The next slot to pop, set by the writer
+  char head_padding[64];
+  std::atomic<std::size_t> tail{0};  // The next slot to push, set by the owner
+  char tail_padding[64];
+  std::atomic<bool> is_retired{false};  // Set by the owner as it exits
+
+  Message_queue() : slots(message_queue_capacity) {}
+
+  bool try_push(std::string& message) {
+    const std::size_t position = tail.load(std::memory_order_relaxed);
+    if (position - head.load(std::memory_order_acquire) == slots.size()) {
+      return false;
+    }
+    slots[position % slots.size()] = std::move(message);
+    tail.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(std::string& message) {
+    const std::size_t position = head.load(std::memory_order_relaxed);
+    if (position == tail.load(std::memory_order_acquire)) return false;
+    message.swap(slots[position % slots.size()]);
+    head.store(position + 1, std::memory_order_release);
+    return true;
   }
+
+  /**
+   * Checks, from the writer thread, whether the queue was retired and all of
+   * its messages were popped, so that no message can arrive any more.
+   */
+  bool is_drained() const {
+    return is_retired.load(std::memory_order_acquire) &&
+           head.load(std::memory_order_relaxed) ==
+               tail.load(std::memory_order_acquire);
+  }
+};
+
+Logger::Logger(bool verbose) : is_verbose(verbose), id(next_logger_id++) {}
+
+std::shared_ptr<Logger> Logger::make_null_logger() {
+  auto logger = std::make_shared<Logger>(false);
+  logger->is_null = true;
   return logger;
 }
 
+Logger::~Logger() {
+  if (!is_writer_started) return;
+  {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    is_stopping = true;
+  }
+  writer_wakeup.notify_one();
+  writer.join();
+}
+
 void Logger::log(const std::string& message, bool always_print = false) {
-  if (is_verbose || always_print) {
-    // Lock the mutex to prevent interleaved output
-    std::lock_guard<std::mutex> lock(mutex);
-    std::cout << message << std::endl;
+  if ((is_enabled() || always_print) && !is_null) {
+    Message_queue& queue = get_thread_queue();
+    std::string line = message + '\n';
+    // A full queue waits for the writer thread, bounding the memory held
+    while (!queue.try_push(line)) {
+      is_writer_needed = true;
+      writer_wakeup.notify_one();
+      std::this_thread::yield();
+    }
+  }
+}
+
+Logger::Message_queue& Logger::get_thread_queue() {
+  // Each thread keeps its queues of the living loggers, and retires them when
+  // it exits. The queue of the logger used last by the thread is cached, so
+  // only the first message of a thread to a logger takes the lock.
+  struct Thread_queues {
+    std::uint64_t cached_logger_id = 0;
+    Message_queue* cached_queue = nullptr;
+    std::vector<std::pair<std::uint64_t, std::weak_ptr<Message_queue>>>
+        queues;
+
+    ~Thread_queues() {
+      for (const auto& entry : queues) {
+        if (auto queue = entry.second.lock()) {
+          queue->is_retired.store(true, std::memory_order_release);
+        }
+      }
+    }
+  };
+  thread_local Thread_queues thread_queues;
+  if (thread_queues.cached_logger_id == id) {
+    return *thread_queues.cached_queue;
+  }
+
+  std::shared_ptr<Message_queue> thread_queue;
+  for (const auto& entry : thread_queues.queues) {
+    if (entry.first == id) thread_queue = entry.second.lock();
+  }
+  if (!thread_queue) {
+    // The queues of destroyed loggers are forgotten on the way
+    thread_queues.queues.erase(
+        std::remove_if(
+            thread_queues.queues.begin(), thread_queues.queues.end(),
+            [](const auto& entry) { return entry.second.expired(); }),
+        thread_queues.queues.end());
+    thread_queue = std::make_shared<Message_queue>();
+    thread_queues.queues.emplace_back(id, thread_queue);
+    std::lock_guard<std::mutex> lock(queues_mutex);
+    queues.push_back(thread_queue);
+    if (!is_writer_started) {
+      writer = std::thread(&Logger::run_writer, this);
+      is_writer_started = true;
+    }
+  }
+  thread_queues.cached_logger_id = id;
+  thread_queues.cached_queue = thread_queue.get();
+  return *thread_queue;
+}
+
+void Logger::run_writer() {
+  std::string batch;
+  std::string message;
+  bool is_idle = true;
+  std::unique_lock<std::mutex> lock(writer_mutex);
+  while (true) {
+    // The writer sleeps only after a pass found nothing to print
+    if (is_idle) {
+      writer_wakeup.wait_for(lock, writer_interval, [this] {
+        return is_stopping || is_writer_needed ||
+               requested_flush_count > completed_flush_count;
+      });
+    }
+    is_writer_needed = false;
+    const std::uint64_t flush_count = requested_flush_count;
+    const bool is_last_pass = is_stopping;
+    std::ostream* stream = output_stream;
+    lock.unlock();
+    {
+      // At most one queue length per thread, so that a busy thread cannot
+      // hold back the others
+      std::lock_guard<std::mutex> queues_lock(queues_mutex);
+      for (const auto& queue : queues) {
+        for (std::size_t i = 0;
+             i < message_queue_capacity && queue->try_pop(message); ++i) {
+          batch += message;
+        }
+      }
+      // The queues of exited threads go once their last messages are taken
+      queues.erase(
+          std::remove_if(queues.begin(), queues.end(),
+                         [](const auto& queue) { return queue->is_drained(); }),
+          queues.end());
+    }
+    is_idle = batch.empty();
+    if (!batch.empty()) {
+      stream->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+      stream->flush();
+      batch.clear();
+    }
+    lock.lock();
+    completed_flush_count = flush_count;
+    flush_completed.notify_all();
+    if (is_last_pass) return;
   }
 }
 
+void Logger::flush() {
+  if (!is_writer_started) return;
+  std::unique_lock<std::mutex> lock(writer_mutex);
+  const std::uint64_t flush_count = ++requested_flush_count;
+  writer_wakeup.notify_one();
+  flush_completed.wait(
+      lock, [&] { return completed_flush_count >= flush_count; });
+}
+
+void Logger::set_output_stream(std::ostream& os) {
+  // The messages logged so far go to the previous stream
+  flush();
+  std::lock_guard<std::mutex> lock(writer_mutex);
+  output_stream = &os;
+}
+
 void Logger::log_mcts_start(Cell_state player) {
   std::ostringstream message;
-  if (get_verbosity()) {
+  if (is_enabled()) {
     message << "\n-------------MCTS VERBOSE START - " << player
             << " to move-------------\n";
     log(message.str());
@@ -31,6 +217,7 @@ void Logger::log_mcts_start(Cell_state player) {
 }
 
 void Logger::log_iteration_number(int iteration_number) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "\n------------------STARTING SIMULATION " << iteration_number
           << "------------------\n";
@@ -38,6 +225,7 @@ void Logger::log_iteration_number(int iteration_number) {
 }
 
 void Logger::log_expanded_child(const std::pair<int, int>& move) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "EXPANDED CHILD " << move.first << ", " << move.second;
   log(message.str());
@@ -45,6 +233,7 @@ void Logger::log_expanded_child(const std::pair<int, int>& move) {
 
 void Logger::log_selected_child(const std::pair<int, int>& move,
                                 double uct_score) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "SELECTED CHILD " << move.first << ", " << move.second
           << " with UCT of ";
@@ -58,7 +247,7 @@ void Logger::log_selected_child(const std::pair<int, int>& move,
 
 void Logger::log_simulation_start(const std::pair<int, int>& move,
                                   const Board& board) {
-  if (is_verbose) {
+  if (is_enabled()) {
     std::ostringstream message;
     std::ostringstream board_string;
     board.display_board(board_string);
@@ -71,7 +260,7 @@ void Logger::log_simulation_start(const std::pair<int, int>& move,
 
 void Logger::log_simulation_step(Cell_state current_player, const Board& board,
                                  const std::pair<int, int>& move) {
-  if (is_verbose) {
+  if (is_enabled()) {
     std::ostringstream message;
     std::ostringstream board_string;
     board.display_board(board_string);
@@ -85,7 +274,7 @@ void Logger::log_simulation_step(Cell_state current_player, const Board& board,
 }
 
 void Logger::log_simulation_end(Cell_state winning_player, const Board& board) {
-  if (is_verbose) {
+  if (is_enabled()) {
     std::ostringstream message;
     std::ostringstream board_string;
     board.display_board(board_string);
@@ -96,8 +285,22 @@ void Logger::log_simulation_end(Cell_state winning_player, const Board& board) {
   }
 }
 
+void Logger::log_simulation_cutoff(Cell_state winning_player,
+                                   double win_probability,
+                                   const Board& board) {
+  if (!is_enabled()) return;
+  std::ostringstream message;
+  std::ostringstream board_string;
+  board.display_board(board_string);
+  message << "CUT OFF simulation, evaluated win for player " << winning_player
+          << " with probability " << win_probability << " in Board state:\n"
+          << board_string.str();
+  log(message.str());
+}
+
 void Logger::log_backpropagation_result(const std::pair<int, int>& move,
                                         int win_count, int visit_count) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "BACKPROPAGATED result to node " << move.first << ", "
           << move.second << ". It currently has " << win_count << " wins and "
@@ -107,6 +310,7 @@ void Logger::log_backpropagation_result(const std::pair<int, int>& move,
 
 void Logger::log_root_stats(int visit_count, int win_count,
                             size_t child_nodes) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "\nAFTER BACKPROPAGATION, root node has " << visit_count
           << " visits, " << win_count << " wins, and " << child_nodes
@@ -116,6 +320,7 @@ void Logger::log_root_stats(int visit_count, int win_count,
 
 void Logger::log_child_node_stats(const std::pair<int, int>& move,
                                   int win_count, int visit_count) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "Child node " << move.first << "," << move.second
           << ": Wins: " << win_count << ", Visits: " << visit_count
@@ -131,6 +336,7 @@ void Logger::log_child_node_stats(const std::pair<int, int>& move,
 }
 
 void Logger::log_timer_ran_out(int iteration_counter) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "\nTIMER RAN OUT. " << iteration_counter
           << " iterations completed. CHOOSING A MOVE FROM ROOT'S CHILDREN:\n";
@@ -139,6 +345,7 @@ void Logger::log_timer_ran_out(int iteration_counter) {
 
 void Logger::log_node_win_ratio(const std::pair<int, int>& move, int win_count,
                                 int visit_count) {
+  if (!is_enabled()) return;
   std::ostringstream win_ratio_stream;
   if (visit_count > 0) {
     win_ratio_stream << std::fixed << std::setprecision(2)
@@ -153,16 +360,75 @@ void Logger::log_node_win_ratio(const std::pair<int, int>& move, int win_count,
   log(message.str());
 }
 
+void Logger::log_search_extension(
+    const std::pair<int, int>& most_visited_move,
+    const std::pair<int, int>& most_valuable_move) {
+  if (!is_enabled()) return;
+  std::ostringstream message;
+  message << "\nMOST VISITED CHILD " << most_visited_move.first << ", "
+          << most_visited_move.second << " AND MOST VALUABLE CHILD "
+          << most_valuable_move.first << ", " << most_valuable_move.second
+          << " DISAGREE. EXTENDING THE SEARCH.";
+  log(message.str());
+}
+
 void Logger::log_best_child_chosen(int iteration_counter,
                                    const std::pair<int, int>& move,
-                                   double win_ratio) {
+                                   const std::string& score_name,
+                                   double score) {
+  if (!is_enabled()) return;
   std::ostringstream message;
   message << "\nAfter " << iteration_counter << " iterations, chose child "
-          << move.first << ", " << move.second << " with win ratio "
-          << std::setprecision(4) << win_ratio;
+          << move.first << ", " << move.second << " with " << score_name
+          << " " << std::setprecision(4) << score;
+  log(message.str());
+}
+
+void Logger::log_swap_decision(const std::pair<int, int>& first_move,
+                               double first_move_value, bool is_swapping) {
+  if (!is_enabled()) return;
+  std::ostringstream message;
+  message << "\nFIRST MOVE " << first_move.first << ", " << first_move.second
+          << " has a win ratio of " << std::setprecision(4)
+          << first_move_value << ". "
+          << (is_swapping ? "SWAPPING." : "NOT SWAPPING.");
+  log(message.str());
+  flush();
+}
+
+void Logger::log_search_statistics(const Search_statistics& statistics) {
+  if (!is_enabled()) return;
+  auto to_milliseconds = [](Search_statistics::Duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+  };
+  std::ostringstream message;
+  message << std::fixed << std::setprecision(2) << "\nSEARCH STATISTICS: "
+          << statistics.iteration_count << " iterations, "
+          << statistics.playout_count << " playouts ("
+          << statistics.get_playouts_per_second() << " per second), "
+          << statistics.nodes_allocated << " nodes allocated, tree depth "
+          << statistics.max_tree_depth << ", "
+          << statistics.pruned_move_count << " inferior moves pruned, "
+          << statistics.search_extension_count
+          << " search extensions.\nTime in ms: selection "
+          << to_milliseconds(statistics.selection_time) << ", expansion "
+          << to_milliseconds(statistics.expansion_time) << ", simulation "
+          << to_milliseconds(statistics.simulation_time)
+          << ", backpropagation "
+          << to_milliseconds(statistics.backpropagation_time) << ", total "
+          << to_milliseconds(statistics.total_time) << ".";
+  for (std::size_t thread_index = 0;
+       thread_index < statistics.thread_busy_times.size(); ++thread_index) {
+    message << "\nPlayout thread " << thread_index << " utilisation: "
+            << 100. * statistics.get_thread_utilisation(thread_index) << "%";
+  }
   log(message.str());
 }
 
 void Logger::log_mcts_end() {
-  log("\n--------------------MCTS VERBOSE END--------------------\n");
+  if (is_enabled()) {
+    log("\n--------------------MCTS VERBOSE END--------------------\n");
+  }
+  // The caller prints after the search, so its messages must be out
+  flush();
 }
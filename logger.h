@@ -1,55 +1,91 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "board.h"
 #include "cell_state.h"
+#include "search_statistics.h"
+
+/**
+ * @brief Compile-time switch for the verbose MCTS logging.
+ *
+ * When defined as 0 (e.g. with the MCTS_VERBOSE_LOGGING CMake option set to
+ * OFF), Logger::is_enabled() is a constant false, so every logging call guarded
+ * by it is removed by the compiler and a production build spends no cycles on
+ * verbose messages. Defaults to 1.
+ */
+#ifndef MCTS_VERBOSE_LOGGING
+#define MCTS_VERBOSE_LOGGING 1
+#endif
 
 /**
  * @class Logger
  *
- * @brief The Logger class provides a thread-safe, singleton logging utility
- *        for the Monte Carlo Tree Search (MCTS) algorithm used in the
- *        Mcts_agent class.
+ * @brief The Logger class provides a thread-safe logging utility for the
+ *        Monte Carlo Tree Search (MCTS) algorithm used in the Mcts_agent
+ *        class.
  *
- * The Logger class is designed as a singleton to ensure that only one logger
- * instance exists across the application, providing a unified source of
- * logging.
+ * Every agent logs through its own Logger, with its own verbosity and output
+ * stream, unless one is shared between agents with Mcts_agent::set_logger().
+ * Concurrent searches with separate loggers therefore share no state. A null
+ * logger discards everything without building a message or starting a
+ * thread, for searches whose output nobody reads.
  *
- * This class is thread-safe, using a mutex to ensure that concurrent writes to
- * the console do not overlap.
+ * This class is thread-safe and writes asynchronously. Each logging thread
+ * appends its messages to a lock-free queue of its own, and a background
+ * writer thread drains the queues and prints the messages in batches, with
+ * one flush per batch instead of one per message. Messages of one thread keep
+ * their order and are never split, so verbose logging works with parallel
+ * playouts, and logging threads never wait for each other or for the console
+ * unless their queue is full. The queue of a thread is dropped once the
+ * thread has exited and its messages are printed, so short-lived threads
+ * leave nothing behind. The writer thread starts with the first message, and
+ * flush() waits for the queued messages to be printed, as at the end of
+ * every search.
  *
  * Logger provides various logging functions specific to different stages of the
  * MCTS algorithm, such as start and end of MCTS, expanding a child node,
  * selecting a child node, and so on. These functions are used to print the
  * status and progress of the MCTS algorithm and its internal state.
  *
- * The verbosity is set at the time of creating the logger instance.
+ * The verbosity is set at the time of creating the logger instance. Every
+ * verbose logging function returns before building its message when the
+ * logger is disabled, and hot call sites are expected to check is_enabled()
+ * first so that a disabled logger costs a single predictable branch.
  */
 class Logger {
  public:
-  /**
-   * @brief Creates or retrieves the singleton Logger instance.
-   *
-   * If the Logger instance does not exist yet, it will be created with the
-   * given verbosity. If it already exists, the verbosity will be ignored and
-   * the existing instance will be returned.
-   *
-   * @param is_verbose Whether the logger should print verbose output.
-   * @return A shared_ptr to the Logger instance.
-   */
-  static std::shared_ptr<Logger> instance(bool is_verbose);
   // Non-copyable and non-movable
   Logger(const Logger&) = delete;
   Logger& operator=(const Logger&) = delete;
   Logger(Logger&&) = delete;
   Logger& operator=(Logger&&) = delete;
-  Logger(bool verbose = false) : is_verbose(verbose) {}
+  /**
+   * @brief Constructs a logger printing to std::cout.
+   *
+   * @param verbose Whether the logger should print verbose output.
+   */
+  explicit Logger(bool verbose = false);
+
+  /**
+   * @brief Creates a logger that discards every message.
+   */
+  static std::shared_ptr<Logger> make_null_logger();
+  /**
+   * @brief Prints the queued messages and stops the writer thread.
+   */
+  ~Logger();
 
   /**
    * @brief Returns the verbosity of the logger.
@@ -58,6 +94,32 @@ class Logger {
    */
   bool get_verbosity() const { return is_verbose; }
 
+  /**
+   * @brief Checks whether verbose messages are printed at all.
+   *
+   * This is the check that callers should use to skip the preparation of
+   * logging arguments. It is inlined and folds to false when verbose logging
+   * is compiled out.
+   *
+   * @return True if verbose logging is compiled in and the logger is verbose.
+   */
+  bool is_enabled() const { return MCTS_VERBOSE_LOGGING && is_verbose; }
+
+  /**
+   * @brief Redirects the messages of the logger, which go to std::cout by
+   * default. The engine mode sends them to std::cerr, so that std::cout
+   * carries only protocol responses. A null logger stays silent.
+   *
+   * @param os The output stream to print to. It must outlive the logger.
+   */
+  void set_output_stream(std::ostream& os);
+
+  /**
+   * @brief Waits until the messages logged so far by the calling thread are
+   * printed and the output stream is flushed.
+   */
+  void flush();
+
   /**
    * @brief Logs the start of an MCTS operation.
    *
@@ -111,6 +173,15 @@ class Logger {
    * @param board The final state of the game board.
    */
   void log_simulation_end(Cell_state winning_player, const Board& board);
+  /**
+   * @brief Logs the end of a game simulation cut off by the static evaluation.
+   *
+   * @param winning_player The winner drawn from the evaluation.
+   * @param win_probability The evaluated probability that the winner wins.
+   * @param board The state of the game board at the cutoff.
+   */
+  void log_simulation_cutoff(Cell_state winning_player, double win_probability,
+                             const Board& board);
 
   /**
    * @brief Logs the result of backpropagating a simulation result through the
@@ -151,6 +222,17 @@ class Logger {
    */
   void log_timer_ran_out(int iteration_counter);
 
+  /**
+   * @brief Logs that the search continues past the decision time because the
+   * most visited and the most valuable child of the root disagree.
+   *
+   * @param most_visited_move The move of the most visited child.
+   * @param most_valuable_move The move of the child with the highest win
+   * ratio.
+   */
+  void log_search_extension(const std::pair<int, int>& most_visited_move,
+                            const std::pair<int, int>& most_valuable_move);
+
   /**
    * @brief Logs the current win ratio of a node.
    *
@@ -166,10 +248,29 @@ class Logger {
    *
    * @param iteration_counter The number of iterations completed.
    * @param move The move associated with the selected child node.
-   * @param win_ratio The win ratio of the selected child node.
+   * @param score_name The name of the score the final move criterion compared.
+   * @param score That score of the selected child node.
    */
   void log_best_child_chosen(int iteration_counter,
-                             const std::pair<int, int>& move, double win_ratio);
+                             const std::pair<int, int>& move,
+                             const std::string& score_name, double score);
+
+  /**
+   * @brief Logs the decision of whether to apply the swap rule.
+   *
+   * @param first_move The first move of the game.
+   * @param first_move_value The win ratio of the first move for its player.
+   * @param is_swapping Whether the agent swaps.
+   */
+  void log_swap_decision(const std::pair<int, int>& first_move,
+                         double first_move_value, bool is_swapping);
+
+  /**
+   * @brief Logs the per-phase counters and timers of a completed search.
+   *
+   * @param statistics The statistics collected by the agent.
+   */
+  void log_search_statistics(const Search_statistics& statistics);
 
   /**
    * @brief Logs the end of an MCTS operation.
@@ -178,17 +279,22 @@ class Logger {
 
  private:
   /**
-   * @brief The singleton instance of the Logger class.
+   * @brief A flag indicating whether the logger should print verbose messages.
    */
-  static std::shared_ptr<Logger> logger;
+  bool is_verbose;
 
   /**
-   * @brief A flag indicating whether the logger should print verbose messages.
+   * @brief The stream the messages are printed to.
    */
-  bool is_verbose;
+  std::ostream* output_stream = &std::cout;
 
   /**
-   * @brief Print a log message to the console.
+   * @brief Whether the logger discards every message, see make_null_logger().
+   */
+  bool is_null = false;
+
+  /**
+   * @brief Queue a log message for printing.
    *
    * If `always_print` is false, the message is only printed if the logger is
    * in verbose mode.
@@ -196,9 +302,53 @@ class Logger {
   void log(const std::string& message, bool always_print);
 
   /**
-   * @brief Mutex for ensuring thread safety when logging.
+   * @brief The lock-free queue of messages of one logging thread, defined in
+   * logger.cpp.
+   */
+  struct Message_queue;
+
+  /**
+   * @brief Returns the queue of the calling thread, registering it and
+   * starting the writer thread on the first message of the thread. The queue
+   * is retired when the thread exits.
+   */
+  Message_queue& get_thread_queue();
+
+  /**
+   * @brief The loop of the writer thread: drains the queues periodically and
+   * on request, until the logger is destroyed.
+   */
+  void run_writer();
+
+  /**
+   * @brief Distinguishes the loggers in the queues cached by each thread.
+   */
+  const std::uint64_t id;
+
+  /**
+   * @brief The queues of the logging threads, guarded by queues_mutex. Each
+   * thread also holds its own as a weak_ptr, to retire them when it exits.
+   */
+  std::vector<std::shared_ptr<Message_queue>> queues;
+  std::mutex queues_mutex;
+
+  /**
+   * @brief The writer thread, started with the first message.
+   */
+  std::thread writer;
+  std::atomic<bool> is_writer_started{false};
+
+  /**
+   * @brief Guards the output stream and the flush and stop requests to the
+   * writer thread.
    */
-  std::mutex mutex;
+  std::mutex writer_mutex;
+  std::condition_variable writer_wakeup;
+  std::condition_variable flush_completed;
+  std::atomic<bool> is_writer_needed{false};
+  std::uint64_t requested_flush_count = 0;
+  std::uint64_t completed_flush_count = 0;
+  bool is_stopping = false;
 };
 
 #endif  // LOGGER_H
@@ -1,9 +1,16 @@
+#include <string>
+#include <vector>
+
 #include "console_interface.h"
 
 /**
- * @brief Calls the run_console_interface() function.
+ * @brief Runs the command-line mode selected by the arguments, or calls the
+ * run_console_interface() function if there are none.
  */
-int main() {
+int main(int argc, char* argv[]) {
+  if (argc > 1) {
+    return run_command_line(std::vector<std::string>(argv + 1, argv + argc));
+  }
   run_console_interface();
   return 0;
 }
@@ -1,24 +1,48 @@
 #include "mcts_agent.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
 #include <memory>
 #include <mutex>
-#include <random>
 #include <sstream>
+#include <stdexcept>
 #include <thread>
+#include <utility>
+
+#include "board_evaluation.h"
+#include "inferior_cell_analysis.h"
+#include "random_generator.h"
+
+namespace {
+
+// The quick search behind the swap decision takes this fraction of the
+// decision time.
+const int swap_search_time_divisor = 4;
+
+// In multi-PV mode, a candidate with fewer visits than this fraction of an
+// even share of the root visits is played out first.
+const double multi_pv_min_visit_share = 0.5;
+
+// A search extension proceeds in slices of this fraction of the decision
+// time, checking after each whether the final move candidates agree.
+const int search_extension_slice_divisor = 10;
+
+}  // namespace
 
 Mcts_agent::Mcts_agent(double exploration_factor,
                        std::chrono::milliseconds max_decision_time,
                        bool is_parallelized, bool is_verbose)
     : exploration_factor(exploration_factor),
       max_decision_time(max_decision_time),
-      logger(Logger::instance(is_verbose)),
-      random_generator(random_device()) {
-  if (is_parallelized && is_verbose) {
-    throw std::logic_error(
-        "Concurrent playouts and verbose mode do not make sense together.");
+      is_parallelized(is_parallelized),
+      is_verbose(is_verbose),
+      logger(std::make_shared<Logger>(is_verbose)) {
+  if (is_parallelized) {
+    // Determine the maximum number of threads available on the hardware.
+    thread_pool = std::make_unique<Thread_pool>(
+        std::max(1u, std::thread::hardware_concurrency()));
   }
 }
 
@@ -27,6 +51,7 @@ Mcts_agent::Node::Node(Cell_state player, std::pair<int, int> move,
     : win_count(0),
       visit_count(0),
       move(move),
+      prior_value(0.5),
       player(player),
       child_nodes(),
       parent_node(parent_node) {}
@@ -34,73 +59,376 @@ Mcts_agent::Node::Node(Cell_state player, std::pair<int, int> move,
 std::pair<int, int> Mcts_agent::choose_move(const Board& board,
                                             Cell_state player) {
   logger->log_mcts_start(player);
-  // Create a new root node for MCTS
-  root = std::make_shared<Node>(player, std::make_pair(-1, -1), nullptr);
+  auto search_start_time = std::chrono::steady_clock::now();
+  // The decision time includes the expansion of the root
+  auto start_time = std::chrono::high_resolution_clock::now();
+  auto end_time = start_time + max_decision_time;
+  // A search of the position searched last continues on its tree, otherwise
+  // a new root node is created. A tree expanded without priors is not reused
+  // once they are needed.
+  const bool is_root_reused = root && root->player == player &&
+                              root_board_size == board.get_board_size() &&
+                              root_hash == board.get_hash() &&
+                              (root_has_priors || !uses_priors());
+  if (!is_root_reused) {
+    root = std::make_shared<Node>(player, std::make_pair(-1, -1), nullptr);
+    root_board_size = board.get_board_size();
+    root_hash = board.get_hash();
+    root_has_priors = uses_priors();
+  }
   // Prepare for potential parallelism
-  unsigned int number_of_threads = 1;
-  if (is_parallelized) {
-    // Determine the maximum number of threads available on the hardware.
-    number_of_threads = std::thread::hardware_concurrency();
+  unsigned int number_of_threads =
+      thread_pool ? thread_pool->get_thread_count() : 1;
+  statistics = Search_statistics();
+  statistics.nodes_allocated = is_root_reused ? 0 : 1;
+  statistics.thread_busy_times.assign(number_of_threads,
+                                      Search_statistics::Duration(0));
+  if (trace) {
+    trace->prepare_threads(number_of_threads);
+    trace->record(0, Trace_event_type::Search_start, player,
+                  std::make_pair(-1, -1), 0, board.get_board_size(),
+                  static_cast<int>(number_of_threads));
   }
   // Expand root based on the current game state
-  expand_node(root, board);
+  if (!is_root_reused) {
+    auto expansion_start_time = std::chrono::steady_clock::now();
+    expand_node(root, board);
+    statistics.expansion_time +=
+        std::chrono::steady_clock::now() - expansion_start_time;
+  }
   int mcts_iteration_counter = 0;
-  auto start_time = std::chrono::high_resolution_clock::now();
-  auto end_time = start_time + max_decision_time;
   // Run MCTS until the timer runs out to update root's and its children's
   // statistics
   perform_mcts_iterations(end_time, mcts_iteration_counter, board,
                           number_of_threads);
+  // Search on while the most visited and the most valuable child disagree,
+  // until the extension budget is spent
+  const auto extension_end_time =
+      end_time + std::chrono::duration_cast<
+                     std::chrono::high_resolution_clock::duration>(
+                     max_decision_time * options.search_extension_ratio);
+  const auto extension_slice =
+      std::max(std::chrono::milliseconds(1),
+               max_decision_time / search_extension_slice_divisor);
+  while (end_time < extension_end_time && !is_search_settled()) {
+    logger->log_search_extension(
+        find_highest_scoring_child(
+            [](const Node& child) { return child.visit_count; })->move,
+        find_highest_scoring_child([this](const Node& child) {
+          return get_child_value(child);
+        })->move);
+    end_time = std::min(extension_end_time, end_time + extension_slice);
+    perform_mcts_iterations(end_time, mcts_iteration_counter, board,
+                            number_of_threads);
+    ++statistics.search_extension_count;
+  }
   logger->log_timer_ran_out(mcts_iteration_counter);
-  // Select the child with the highest win ratio as the best move:
-  std::shared_ptr<Node> best_child = select_best_child();
-  logger->log_best_child_chosen(
-      mcts_iteration_counter, best_child->move,
-      static_cast<double>(best_child->win_count) / best_child->visit_count);
+  // Select the best move by the final move criterion:
+  std::string best_score_name;
+  double best_score = 0.;
+  std::shared_ptr<Node> best_child =
+      select_best_child(best_score_name, best_score);
+  logger->log_best_child_chosen(mcts_iteration_counter, best_child->move,
+                                best_score_name, best_score);
+  last_best_move = best_child->move;
+  statistics.iteration_count = mcts_iteration_counter;
+  statistics.total_time = std::chrono::steady_clock::now() - search_start_time;
+  logger->log_search_statistics(statistics);
   logger->log_mcts_end();
+  if (trace) {
+    trace->record(0, Trace_event_type::Search_end, player, best_child->move,
+                  mcts_iteration_counter, best_child->win_count,
+                  best_child->visit_count);
+  }
   return best_child->move;
 }
 
+Search_analysis Mcts_agent::analyze(const Board& board, Cell_state player) {
+  choose_move(board, player);
+  return get_last_search_analysis();
+}
+
+bool Mcts_agent::choose_swap(const Board& board,
+                             const std::pair<int, int>& first_move) {
+  const int board_size = board.get_board_size();
+  double first_move_value = get_first_move_values(
+      board_size)[first_move.first * board_size + first_move.second];
+  bool is_swapping = first_move_value > 0.5;
+  logger->log_swap_decision(first_move, first_move_value, is_swapping);
+  return is_swapping;
+}
+
+const std::vector<double>& Mcts_agent::get_first_move_values(int board_size) {
+  auto table = first_move_values.find(board_size);
+  if (table != first_move_values.end()) {
+    return table->second;
+  }
+  // Search the empty board with a reduced budget on a separate agent, so
+  // that the tree of this agent is kept
+  const std::chrono::milliseconds quick_search_time =
+      std::max(std::chrono::milliseconds(1),
+               max_decision_time / swap_search_time_divisor);
+  Mcts_agent quick_search(exploration_factor, quick_search_time, false,
+                          is_verbose);
+  quick_search.logger = logger;
+  quick_search.options = options;
+  quick_search.is_parallelized = is_parallelized;
+  quick_search.thread_pool = std::move(thread_pool);
+  try {
+    quick_search.choose_move(Board(board_size), Cell_state::Blue);
+  } catch (...) {
+    thread_pool = std::move(quick_search.thread_pool);
+    throw;
+  }
+  thread_pool = std::move(quick_search.thread_pool);
+  // A first move and its 180 degree rotation are equivalent, so their
+  // statistics are pooled (the centre is simply counted twice).
+  const Board empty_board(board_size);
+  std::vector<int> win_counts(board_size * board_size, 0);
+  std::vector<int> visit_counts(board_size * board_size, 0);
+  for (const auto& child : quick_search.root->child_nodes) {
+    for (const auto& cell :
+         {child->move,
+          empty_board.transform_cell(child->move, Board_symmetry::Rotation)}) {
+      win_counts[cell.first * board_size + cell.second] += child->win_count;
+      visit_counts[cell.first * board_size + cell.second] +=
+          child->visit_count;
+    }
+  }
+  std::vector<double> values(board_size * board_size, 0.5);
+  for (std::size_t cell = 0; cell < values.size(); ++cell) {
+    if (visit_counts[cell] > 0) {
+      values[cell] = static_cast<double>(win_counts[cell]) / visit_counts[cell];
+    }
+  }
+  return first_move_values.emplace(board_size, std::move(values)).first->second;
+}
+
+void Mcts_agent::set_trace(std::shared_ptr<Search_trace> search_trace) {
+  trace = std::move(search_trace);
+}
+
+void Mcts_agent::set_logger(std::shared_ptr<Logger> search_logger) {
+  if (!search_logger) {
+    throw std::invalid_argument("The logger cannot be null.");
+  }
+  logger = std::move(search_logger);
+}
+
+void Mcts_agent::set_search_options(const Search_options& search_options) {
+  search_options.validate();
+  options = search_options;
+}
+
+const Search_options& Mcts_agent::get_search_options() const {
+  return options;
+}
+
+void Mcts_agent::set_prior_knowledge(int prior_visit_count,
+                                     double progressive_bias_weight) {
+  Search_options updated_options = options;
+  updated_options.prior_visit_count = prior_visit_count;
+  updated_options.progressive_bias_weight = progressive_bias_weight;
+  set_search_options(updated_options);
+}
+
+void Mcts_agent::set_progressive_widening(double widening_constant,
+                                          double widening_exponent) {
+  Search_options updated_options = options;
+  updated_options.widening_constant = widening_constant;
+  updated_options.widening_exponent = widening_exponent;
+  set_search_options(updated_options);
+}
+
+void Mcts_agent::set_max_decision_time(
+    std::chrono::milliseconds max_decision_time) {
+  if (max_decision_time.count() <= 0) {
+    throw std::invalid_argument("The decision time must be positive.");
+  }
+  this->max_decision_time = max_decision_time;
+}
+
+void Mcts_agent::set_selection_policy(Selection_policy_type policy) {
+  options.selection_policy = policy;
+}
+
+void Mcts_agent::set_final_move_criterion(Final_move_criterion criterion) {
+  options.final_move_criterion = criterion;
+}
+
+void Mcts_agent::set_search_extension(double max_extension_ratio) {
+  Search_options updated_options = options;
+  updated_options.search_extension_ratio = max_extension_ratio;
+  set_search_options(updated_options);
+}
+
+void Mcts_agent::set_multi_pv(int move_count) {
+  Search_options updated_options = options;
+  updated_options.multi_pv_count = move_count;
+  set_search_options(updated_options);
+}
+
+void Mcts_agent::set_playout_cutoff_depth(int depth) {
+  Search_options updated_options = options;
+  updated_options.playout_cutoff_depth = depth;
+  set_search_options(updated_options);
+}
+
+const Search_statistics& Mcts_agent::get_last_search_statistics() const {
+  return statistics;
+}
+
+std::vector<Child_statistics> Mcts_agent::get_root_child_statistics() const {
+  std::vector<Child_statistics> child_statistics;
+  if (!root) return child_statistics;
+  const Selection_context context =
+      make_selection_context(*root, get_selectable_child_count(*root));
+  child_statistics.reserve(root->child_nodes.size());
+  for (const auto& child : root->child_nodes) {
+    Child_statistics child_entry{};
+    child_entry.move = child->move;
+    child_entry.win_count = child->win_count;
+    child_entry.visit_count = child->visit_count;
+    child_entry.value = get_child_value(*child);
+    child_entry.selection_score = get_selection_score(*child, context);
+    child_statistics.push_back(std::move(child_entry));
+  }
+  return child_statistics;
+}
+
+Search_analysis Mcts_agent::get_last_search_analysis() const {
+  Search_analysis analysis;
+  analysis.best_move = last_best_move;
+  analysis.children = get_root_child_statistics();
+  if (root) {
+    for (std::size_t index : get_multi_pv_candidates()) {
+      analysis.top_moves.push_back(analysis.children[index]);
+    }
+  }
+  std::stable_sort(analysis.children.begin(), analysis.children.end(),
+                   [](const Child_statistics& first,
+                      const Child_statistics& second) {
+                     return first.visit_count > second.visit_count;
+                   });
+  for (const auto& child : analysis.children) {
+    if (child.move == last_best_move) analysis.best_move_value = child.value;
+  }
+  analysis.statistics = statistics;
+  return analysis;
+}
+
 void Mcts_agent::expand_node(const std::shared_ptr<Node>& node,
                              const Board& board) {
-  std::vector<std::pair<int, int>> valid_moves = board.get_valid_moves();
-  // For each valid move, create a new child node and add it to the node's
+  // Only the moves that the inferior cell analysis cannot rule out become
   // children.
+  std::vector<std::pair<int, int>> valid_moves =
+      Inferior_cell_analysis(board, node->player).get_candidate_moves();
+  statistics.pruned_move_count +=
+      static_cast<int>(board.get_valid_moves().size() - valid_moves.size());
+  // The static evaluation of every child is far more expensive than the
+  // expansion itself, so it is skipped when nothing reads the priors
+  const bool is_prior_needed = uses_priors();
+  Board child_board = board;
   for (const auto& move : valid_moves) {
     std::shared_ptr<Node> new_child =
         std::make_shared<Node>(node->player, move, node);
+    if (is_prior_needed) {
+      child_board = board;
+      child_board.make_move(move.first, move.second, node->player);
+      new_child->prior_value =
+          (evaluate_position(child_board, node->player) +
+           get_move_heuristic(board, move, node->player)) /
+          2.;
+    }
     node->child_nodes.push_back(new_child);
-    logger->log_expanded_child(move);
+    if (logger->is_enabled()) logger->log_expanded_child(move);
+  }
+  if (is_prior_needed) {
+    std::stable_sort(node->child_nodes.begin(), node->child_nodes.end(),
+                     [](const std::shared_ptr<Node>& first,
+                        const std::shared_ptr<Node>& second) {
+                       return first->prior_value > second->prior_value;
+                     });
   }
+  statistics.nodes_allocated += static_cast<long long>(valid_moves.size());
+}
+
+bool Mcts_agent::uses_priors() const {
+  return options.prior_visit_count > 0 ||
+         options.progressive_bias_weight > 0. ||
+         options.widening_constant > 0. ||
+         options.selection_policy == Selection_policy_type::Puct;
+}
+
+std::size_t Mcts_agent::get_selectable_child_count(const Node& node) const {
+  if (options.widening_constant <= 0.) return node.child_nodes.size();
+  const double width =
+      std::ceil(options.widening_constant *
+                std::pow(node.visit_count + 1., options.widening_exponent));
+  // The comparison in double avoids overflowing the conversion
+  if (width >= static_cast<double>(node.child_nodes.size())) {
+    return node.child_nodes.size();
+  }
+  return std::max<std::size_t>(1, static_cast<std::size_t>(width));
 }
 
 void Mcts_agent::perform_mcts_iterations(
     const std::chrono::time_point<std::chrono::high_resolution_clock>& end_time,
     int& mcts_iteration_counter, const Board& board,
     unsigned int number_of_threads) {
-  while (std::chrono::high_resolution_clock::now() < end_time) {
-    logger->log_iteration_number(mcts_iteration_counter + 1);
+  // A root whose expansion used up the decision time still gets one
+  // iteration, so that a move can be chosen
+  while (root->visit_count == 0 ||
+         std::chrono::high_resolution_clock::now() < end_time) {
+    current_iteration = mcts_iteration_counter + 1;
+    if (logger->is_enabled()) {
+      logger->log_iteration_number(current_iteration);
+    }
+    if (trace) {
+      trace->record(0, Trace_event_type::Iteration_start, Cell_state::Empty,
+                    std::make_pair(-1, -1), current_iteration);
+    }
     // Select a child node for playout using UCT
+    auto selection_start_time = std::chrono::steady_clock::now();
     std::shared_ptr<Node> chosen_child = select_child_for_playout(root);
+    auto simulation_start_time = std::chrono::steady_clock::now();
+    statistics.selection_time += simulation_start_time - selection_start_time;
+    int depth = 0;
+    for (Node* node = chosen_child.get(); node->parent_node;
+         node = node->parent_node.get()) {
+      ++depth;
+    }
+    statistics.max_tree_depth = std::max(statistics.max_tree_depth, depth);
     // If parallelization is enabled, run playouts concurrently:
+    std::vector<Cell_state> results;
     if (is_parallelized) {
-      std::vector<Cell_state> results =
-          parallel_playout(chosen_child, board, number_of_threads);
-      // Backpropagate each of the results
-      for (Cell_state playout_winner : results) {
-        backpropagate(chosen_child, playout_winner);
-      }
+      results = parallel_playout(chosen_child, board, number_of_threads);
       // Else, just do a single playout:
     } else {
-      Cell_state playout_winner = simulate_random_playout(chosen_child, board);
+      results.push_back(simulate_random_playout(chosen_child, board));
+    }
+    auto backpropagation_start_time = std::chrono::steady_clock::now();
+    statistics.simulation_time +=
+        backpropagation_start_time - simulation_start_time;
+    if (!is_parallelized) {
+      statistics.thread_busy_times[0] +=
+          backpropagation_start_time - simulation_start_time;
+    }
+    statistics.playout_count += static_cast<long long>(results.size());
+    // Backpropagate each of the results
+    for (Cell_state playout_winner : results) {
       backpropagate(chosen_child, playout_winner);
     }
-    // Print statistics:
-    logger->log_root_stats(root->visit_count, root->win_count,
-                           root->child_nodes.size());
-    for (const auto& child : root->child_nodes) {
-      logger->log_child_node_stats(child->move, child->win_count,
-                                   child->visit_count);
+    statistics.backpropagation_time +=
+        std::chrono::steady_clock::now() - backpropagation_start_time;
+    // Print statistics (skipped entirely when logging is disabled):
+    if (logger->is_enabled()) {
+      logger->log_root_stats(root->visit_count, root->win_count,
+                             root->child_nodes.size());
+      for (const auto& child : root->child_nodes) {
+        logger->log_child_node_stats(child->move, child->win_count,
+                                     child->visit_count);
+      }
     }
     mcts_iteration_counter++;
   }
@@ -108,90 +436,246 @@ void Mcts_agent::perform_mcts_iterations(
 
 std::shared_ptr<Mcts_agent::Node> Mcts_agent::select_child_for_playout(
     const std::shared_ptr<Node>& parent_node) {
-  // Initialize best_child as the first child and calculate its UCT score
+  if (options.multi_pv_count > 1 && parent_node == root) {
+    std::shared_ptr<Node> candidate = select_multi_pv_candidate();
+    if (candidate) {
+      if (logger->is_enabled()) {
+        logger->log_selected_child(candidate->move,
+                                   get_child_value(*candidate));
+      }
+      if (trace) {
+        trace->record(0, Trace_event_type::Selection, candidate->player,
+                      candidate->move, current_iteration,
+                      candidate->win_count, candidate->visit_count,
+                      get_child_value(*candidate));
+      }
+      return candidate;
+    }
+  }
+  // Branch once on the policy; each policy has its own selection loop
+  switch (options.selection_policy) {
+    case Selection_policy_type::Ucb1_tuned:
+      return select_child_with_policy<Ucb1_tuned_policy>(parent_node);
+    case Selection_policy_type::Puct:
+      return select_child_with_policy<Puct_policy>(parent_node);
+    case Selection_policy_type::Thompson:
+      return select_child_with_policy<Thompson_policy>(parent_node);
+    case Selection_policy_type::Ucb1:
+    default:
+      return select_child_with_policy<Ucb1_policy>(parent_node);
+  }
+}
+
+std::shared_ptr<Mcts_agent::Node> Mcts_agent::select_multi_pv_candidate()
+    const {
+  const std::vector<std::size_t> candidates = get_multi_pv_candidates();
+  // Until enough children were visited, the policy explores the new ones
+  if (candidates.size() < static_cast<std::size_t>(options.multi_pv_count)) {
+    return nullptr;
+  }
+  const Node* least_visited = root->child_nodes[candidates[0]].get();
+  std::size_t least_visited_index = candidates[0];
+  for (std::size_t index : candidates) {
+    if (root->child_nodes[index]->visit_count < least_visited->visit_count) {
+      least_visited = root->child_nodes[index].get();
+      least_visited_index = index;
+    }
+  }
+  const double min_visit_count =
+      multi_pv_min_visit_share * root->visit_count / options.multi_pv_count;
+  if (least_visited->visit_count >= min_visit_count) return nullptr;
+  return root->child_nodes[least_visited_index];
+}
+
+std::vector<std::size_t> Mcts_agent::get_multi_pv_candidates() const {
+  std::vector<std::size_t> candidates;
+  candidates.reserve(root->child_nodes.size());
+  for (std::size_t i = 0; i < root->child_nodes.size(); ++i) {
+    if (root->child_nodes[i]->visit_count > 0) candidates.push_back(i);
+  }
+  const std::size_t candidate_count = std::min(
+      candidates.size(), static_cast<std::size_t>(options.multi_pv_count));
+  // Ties keep the order of the children, i.e. of their priors
+  std::partial_sort(candidates.begin(), candidates.begin() + candidate_count,
+                    candidates.end(), [this](std::size_t first,
+                                             std::size_t second) {
+                      const double first_value =
+                          get_child_value(*root->child_nodes[first]);
+                      const double second_value =
+                          get_child_value(*root->child_nodes[second]);
+                      return first_value > second_value ||
+                             (first_value == second_value && first < second);
+                    });
+  candidates.resize(candidate_count);
+  return candidates;
+}
+
+template <typename Policy>
+std::shared_ptr<Mcts_agent::Node> Mcts_agent::select_child_with_policy(
+    const std::shared_ptr<Node>& parent_node) {
+  // Only the children admitted by progressive widening, which lead the list
+  // in prior order, are considered
+  const std::size_t selectable_child_count =
+      get_selectable_child_count(*parent_node);
+  // Widening admits at least one child, so this only fails for a node
+  // without moves, e.g. the root of a full board
+  if (selectable_child_count == 0) {
+    throw std::runtime_error("There are no moves to select from.");
+  }
+  const auto selectable_end =
+      parent_node->child_nodes.begin() +
+      static_cast<std::ptrdiff_t>(selectable_child_count);
+  const Selection_context context =
+      make_selection_context(*parent_node, selectable_child_count);
+  // Initialize best_child as the first child and calculate its score
   std::shared_ptr<Node> best_child = parent_node->child_nodes[0];
-  double max_score = calculate_uct_score(best_child, parent_node);
-  // Iterate over the remaining child nodes to find the one with the highest UCT
+  double max_score = calculate_selection_score<Policy>(*best_child, context);
+  // Iterate over the remaining child nodes to find the one with the highest
   // score
   for (auto iterator = std::next(parent_node->child_nodes.begin());
-       iterator != parent_node->child_nodes.end(); ++iterator) {
+       iterator != selectable_end; ++iterator) {
     const auto& child = *iterator;
-    double uct_score = calculate_uct_score(child, parent_node);
+    double score = calculate_selection_score<Policy>(*child, context);
 
-    if (uct_score > max_score) {
-      max_score = uct_score;
+    if (score > max_score) {
+      max_score = score;
       best_child = child;
     }
   }
-  // If verbose mode is enabled, print the move coordinates and UCT score of the
+  // If verbose mode is enabled, print the move coordinates and score of the
   // selected child
-  logger->log_selected_child(best_child->move, max_score);
+  if (logger->is_enabled()) {
+    logger->log_selected_child(best_child->move, max_score);
+  }
+  if (trace) {
+    trace->record(0, Trace_event_type::Selection, best_child->player,
+                  best_child->move, current_iteration, best_child->win_count,
+                  best_child->visit_count, max_score);
+  }
   return best_child;
 }
 
-double Mcts_agent::calculate_uct_score(
-    const std::shared_ptr<Node>& child_node,
-    const std::shared_ptr<Node>& parent_node) {
-  // If any child node has not been visited yet, return a high value to
-  // encourage exploration
-  if (child_node->visit_count == 0) {
-    return std::numeric_limits<double>::max();
-  } else {
-    // Otherwise, calculate the UCT score using the UCT formula.
-    return static_cast<double>(child_node->win_count) /
-               child_node->visit_count +
-           exploration_factor * std::sqrt(std::log(parent_node->visit_count) /
-                                          child_node->visit_count);
+template <typename Policy>
+double Mcts_agent::calculate_selection_score(
+    const Node& child_node, const Selection_context& context) const {
+  // The virtual playouts of the prior count as wins and visits of the child
+  const double score = Policy::score(
+      child_node.win_count + options.prior_visit_count * child_node.prior_value,
+      child_node.visit_count + static_cast<double>(options.prior_visit_count),
+      child_node.prior_value, context);
+  return score + options.progressive_bias_weight * child_node.prior_value /
+                     (child_node.visit_count + 1);
+}
+
+Selection_context Mcts_agent::make_selection_context(
+    const Node& parent_node, std::size_t selectable_child_count) const {
+  Selection_context context;
+  context.exploration_factor = exploration_factor;
+  // The virtual playouts of the prior count as visits of the parent
+  context.parent_visit_count =
+      parent_node.visit_count +
+      static_cast<double>(options.prior_visit_count) * selectable_child_count;
+  context.log_parent_visit_count = std::log(context.parent_visit_count);
+  context.prior_sum = 0.;
+  for (std::size_t i = 0; i < selectable_child_count; ++i) {
+    context.prior_sum += parent_node.child_nodes[i]->prior_value;
+  }
+  context.random_generator = &Random_generator::for_current_thread();
+  return context;
+}
+
+double Mcts_agent::get_selection_score(const Node& child_node,
+                                       const Selection_context& context) const {
+  switch (options.selection_policy) {
+    case Selection_policy_type::Ucb1_tuned:
+      return calculate_selection_score<Ucb1_tuned_policy>(child_node, context);
+    case Selection_policy_type::Puct:
+      return calculate_selection_score<Puct_policy>(child_node, context);
+    case Selection_policy_type::Thompson:
+      return calculate_selection_score<Thompson_policy>(child_node, context);
+    case Selection_policy_type::Ucb1:
+    default:
+      return calculate_selection_score<Ucb1_policy>(child_node, context);
   }
 }
 
 Cell_state Mcts_agent::simulate_random_playout(
-    const std::shared_ptr<Node>& node, Board board) {
+    const std::shared_ptr<Node>& node, Board board, unsigned int thread_index) {
+  Random_generator& random_generator = Random_generator::for_current_thread();
   // Start the simulation with the player at the node's move
   Cell_state current_player = node->player;
   // Make the move at the node to make random moves from it
-  board.make_move(node->move.first, node->move.second, current_player);
-  logger->log_simulation_start(node->move, board);
-  // Continue simulation until a winner is detected
-  while (board.check_winner() == Cell_state::Empty) {
+  Cell_state winner =
+      board.make_move(node->move.first, node->move.second, current_player);
+  if (logger->is_enabled()) logger->log_simulation_start(node->move, board);
+  if (trace) {
+    trace->record(thread_index, Trace_event_type::Playout_start,
+                  current_player, node->move, current_iteration);
+  }
+  int playout_depth = 0;
+  // Continue simulation until a move wins, as reported by make_move()
+  while (winner == Cell_state::Empty) {
     // Switch player
     current_player = (current_player == Cell_state::Blue) ? Cell_state::Red
                                                           : Cell_state::Blue;
     // Get valid moves
     std::vector<std::pair<int, int>> valid_moves = board.get_valid_moves();
-    // Generate a distribution and choose a move randomly
-    std::uniform_int_distribution<> distribution(
-        0, static_cast<int>(valid_moves.size() - 1));
-    std::pair<int, int> random_move =
-        valid_moves[distribution(random_generator)];
-    logger->log_simulation_step(current_player, board, random_move);
-    board.make_move(random_move.first, random_move.second, current_player);
+    // Choose a move uniformly at random
+    std::pair<int, int> random_move = valid_moves[random_generator.next_bounded(
+        static_cast<std::uint32_t>(valid_moves.size()))];
+    if (logger->is_enabled()) {
+      logger->log_simulation_step(current_player, board, random_move);
+    }
+    if (trace) {
+      trace->record(thread_index, Trace_event_type::Playout_move,
+                    current_player, random_move, current_iteration);
+    }
+    winner =
+        board.make_move(random_move.first, random_move.second, current_player);
     // If a player has won, break the loop
-    if (board.check_winner() != Cell_state::Empty) {
-      logger->log_simulation_end(current_player, board);
+    if (winner != Cell_state::Empty) {
+      if (logger->is_enabled()) {
+        logger->log_simulation_end(current_player, board);
+      }
+      break;
+    }
+    // Score the rest of the game statically once the cutoff depth is reached
+    if (options.playout_cutoff_depth > 0 &&
+        ++playout_depth >= options.playout_cutoff_depth) {
+      double blue_win_probability = evaluate_position(board, Cell_state::Blue);
+      current_player = random_generator.next_double() < blue_win_probability
+                           ? Cell_state::Blue
+                           : Cell_state::Red;
+      if (logger->is_enabled()) {
+        logger->log_simulation_cutoff(current_player,
+                                      current_player == Cell_state::Blue
+                                          ? blue_win_probability
+                                          : 1. - blue_win_probability,
+                                      board);
+      }
       break;
     }
   }
+  if (trace) {
+    trace->record(thread_index, Trace_event_type::Playout_end, current_player,
+                  std::make_pair(-1, -1), current_iteration);
+  }
   return current_player;
 }
 
 std::vector<Cell_state> Mcts_agent::parallel_playout(
     std::shared_ptr<Node> node, const Board& board,
     unsigned int number_of_threads) {
-  // Create a vector of threads and a vector to store the results
-  std::vector<std::thread> threads;
+  // Run one playout on every thread of the pool and put their separate
+  // results into a vector
   std::vector<Cell_state> results(number_of_threads);
-  // Start the threads and put their separate results into a vector
-  for (unsigned int thread_index = 0; thread_index < number_of_threads;
-       thread_index++) {
-    threads.push_back(std::thread([&, thread_index]() {
-      results[thread_index] = simulate_random_playout(node, board);
-    }));
-  }
-  // Join the threads
-  for (auto& thread : threads) {
-    thread.join();
-  }
+  thread_pool->run([&](unsigned int thread_index) {
+    auto playout_start_time = std::chrono::steady_clock::now();
+    results[thread_index] = simulate_random_playout(node, board, thread_index);
+    // Each thread only writes its own entry, so no locking is needed
+    statistics.thread_busy_times[thread_index] +=
+        std::chrono::steady_clock::now() - playout_start_time;
+  });
   return results;
 }
 
@@ -208,29 +692,112 @@ void Mcts_agent::backpropagate(std::shared_ptr<Node>& node, Cell_state winner) {
     if (winner == current_node->player) {
       current_node->win_count += 1;
     }
-    logger->log_backpropagation_result(
-        current_node->move, current_node->win_count, current_node->visit_count);
+    if (logger->is_enabled()) {
+      logger->log_backpropagation_result(current_node->move,
+                                         current_node->win_count,
+                                         current_node->visit_count);
+    }
+    if (trace) {
+      trace->record(0, Trace_event_type::Backpropagation, current_node->player,
+                    current_node->move, current_iteration,
+                    current_node->win_count, current_node->visit_count);
+    }
     // Move to the parent node for the next iteration
     current_node = current_node->parent_node;
   }
 }
 
-std::shared_ptr<Mcts_agent::Node> Mcts_agent::select_best_child() {
-  double max_win_ratio = -1.;
+double Mcts_agent::get_child_value(const Node& child_node) const {
+  if (child_node.visit_count + options.prior_visit_count == 0) return 0.;
+  return (child_node.win_count +
+          options.prior_visit_count * child_node.prior_value) /
+         (child_node.visit_count + options.prior_visit_count);
+}
+
+template <typename Score>
+std::shared_ptr<Mcts_agent::Node> Mcts_agent::find_highest_scoring_child(
+    Score score, double* max_score_out) const {
   std::shared_ptr<Node> best_child;
-  // iterate over the child nodes of the root node to find the one with the
-  // highest win ratio
+  double max_score = 0.;
   for (const auto& child : root->child_nodes) {
-    double win_ratio =
-        static_cast<double>(child->win_count) / child->visit_count;
-    // If verbose mode is on, print the win ratio for each child node.
-    logger->log_node_win_ratio(child->move, child->win_count,
-                               child->visit_count);
-    if (win_ratio > max_win_ratio) {
-      max_win_ratio = win_ratio;
+    if (child->visit_count == 0) continue;
+    const double child_score = score(*child);
+    if (!best_child || child_score > max_score) {
+      max_score = child_score;
       best_child = child;
     }
   }
+  if (max_score_out) *max_score_out = max_score;
+  return best_child;
+}
+
+bool Mcts_agent::is_search_settled() const {
+  const std::shared_ptr<Node> most_visited_child = find_highest_scoring_child(
+      [](const Node& child) { return child.visit_count; });
+  const std::shared_ptr<Node> most_valuable_child =
+      find_highest_scoring_child(
+          [this](const Node& child) { return get_child_value(child); });
+  return most_visited_child == most_valuable_child;
+}
+
+std::shared_ptr<Mcts_agent::Node> Mcts_agent::select_best_child(
+    std::string& score_name, double& best_score) {
+  // If verbose mode is on, print the win ratio for each child node.
+  if (logger->is_enabled()) {
+    for (const auto& child : root->child_nodes) {
+      logger->log_node_win_ratio(child->move, child->win_count,
+                                 child->visit_count);
+    }
+  }
+  // Children that were never searched, e.g. beyond the progressive widening,
+  // are not candidates
+  const auto visit_count = [](const Node& child) { return child.visit_count; };
+  std::shared_ptr<Node> best_child;
+  switch (options.final_move_criterion) {
+    case Final_move_criterion::Most_visits:
+      score_name = "visit count";
+      best_child = find_highest_scoring_child(visit_count, &best_score);
+      break;
+    case Final_move_criterion::Robust_max:
+      // The child with both the most visits and the highest win ratio, else
+      // the one with the most visits and wins together
+      if (is_search_settled()) {
+        score_name = "visit count";
+        best_child = find_highest_scoring_child(visit_count, &best_score);
+      } else {
+        score_name = "visit and win count";
+        best_child = find_highest_scoring_child(
+            [](const Node& child) {
+              return child.visit_count + child.win_count;
+            },
+            &best_score);
+      }
+      break;
+    case Final_move_criterion::Secure_child: {
+      // The lower confidence bound mirrors the exploration term of UCB1
+      const double log_root_visit_count = std::log(
+          root->visit_count + static_cast<double>(options.prior_visit_count) *
+                                  root->child_nodes.size());
+      score_name = "lower confidence bound";
+      best_child = find_highest_scoring_child(
+          [&](const Node& child) {
+            return get_child_value(child) -
+                   exploration_factor *
+                       std::sqrt(log_root_visit_count /
+                                 (child.visit_count +
+                                  options.prior_visit_count));
+          },
+          &best_score);
+      break;
+    }
+    case Final_move_criterion::Max_value:
+    default:
+      score_name = "win ratio";
+      best_child = find_highest_scoring_child(
+          [this](const Node& child) { return get_child_value(child); },
+          &best_score);
+      break;
+  }
   if (!best_child) {
     throw std::runtime_error(
         "Statistics are not sufficient to choose a move. You likely gave the "
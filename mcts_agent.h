@@ -2,13 +2,20 @@
 #define MCTS_AGENT_H
 
 #include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <mutex>
-#include <random>
+#include <string>
 #include <vector>
 
 #include "board.h"
 #include "logger.h"
+#include "search_options.h"
+#include "search_statistics.h"
+#include "search_trace.h"
+#include "selection_policy.h"
+#include "thread_pool.h"
 
 /**
  * @class Mcts_agent
@@ -23,7 +30,8 @@
  * MCTS works by simulating the game from the current state to a terminal state,
  * then updating the statistics of each visited node based on the outcome. This
  * is done repeatedly until a pre-set time limit is reached. The agent then
- * chooses the move that leads to the node with the highest win ratio.
+ * chooses the move that leads to the node with the highest win ratio, or the
+ * best node by another final move criterion.
  *
  * @note This class assumes a game interface with `Board` and `Cell_state` types
  * defined, and a `Logger` class for logging purposes. The `Board` class should
@@ -54,10 +62,8 @@ class Mcts_agent {
    * @param is_parallelized Determines if playouts are performed in parallel.
    * Sufficient time has to be given for this to be effective.
    * @param is_verbose If true, enables detailed logging to the console
-   * using the Logger class.
-   *
-   * @throws std::logic_error if is_parallelized and is_verbose are both true.
-   * This is because the output would be garbled.
+   * using a Logger of the agent's own, see set_logger(). The messages of
+   * concurrent playouts interleave but are never split.
    */
   Mcts_agent(double exploration_factor,
              std::chrono::milliseconds max_decision_time, bool is_parallelized,
@@ -73,14 +79,18 @@ class Mcts_agent {
    * simulations to make a decision.
    *
    * The function creates a new root node for the MCTS, then expands this node
-   * based on the current game state. It then enters a loop in which it selects
-   * a child node, simulates a game from this node, and backpropagates the
-   * result of the game back up the tree. This loop continues until the
-   * allocated decision-making time is exhausted.
+   * based on the current game state. If the agent searched the same position
+   * with the same player to move last, it keeps that root and its statistics
+   * instead, so repeated searches of a position build on each other. It then
+   * enters a loop in which it selects a child node, simulates a game from this
+   * node, and backpropagates the result of the game back up the tree. This
+   * loop continues until the allocated decision-making time is exhausted.
    *
-   * After the loop, the function chooses the child of the root node with the
-   * highest win ratio as the best move. If verbose mode is active, it also
-   * prints various statistics about the MCTS process using Logger.
+   * After the loop, the search is optionally extended while the most visited
+   * and the most valuable child disagree, and the function chooses the best
+   * child of the root node by the final move criterion, the highest win ratio
+   * by default. If verbose mode is active, it also prints various statistics
+   * about the MCTS process using Logger.
    *
    * Note: The function can work in both a single-threaded and a multi-threaded
    * mode. The latter is activated by setting `is_parallelized` to `true`.
@@ -95,6 +105,223 @@ class Mcts_agent {
    */
   std::pair<int, int> choose_move(const Board& board, Cell_state player);
 
+  /**
+   * @brief Chooses a move like choose_move() and returns the analysis of the
+   * search instead of the move alone.
+   *
+   * @param board The current game state.
+   * @param player The player for whom the move is being chosen.
+   * @return The analysis of the search, see get_last_search_analysis().
+   * @throws runtime_error If the statistics are not sufficient to choose a
+   * move.
+   */
+  Search_analysis analyze(const Board& board, Cell_state player);
+
+  /**
+   * @brief Decides whether the second player should apply the swap rule.
+   *
+   * Swapping turns the first stone into a stone of the second player at the
+   * mirrored cell with the first player to move, which by the symmetry of the
+   * board is as good for the second player as the first move was for the first
+   * player. The agent therefore swaps if the first move has a win ratio above
+   * 0.5 in a table of first-move values. The table is computed once per board
+   * size and agent with a quick search of the empty board, taking a quarter
+   * of the decision time, and leaves the tree and the analysis of the last
+   * search untouched.
+   *
+   * @param board The current game state, holding only the first move.
+   * @param first_move The first move of the game.
+   * @return True if the agent chooses to swap.
+   */
+  bool choose_swap(const Board& board, const std::pair<int, int>& first_move);
+
+  /**
+   * @brief Attaches a binary search trace to the agent.
+   *
+   * When a trace is attached, every search records its iterations,
+   * selections, playout moves and backpropagation updates into it. Unlike
+   * verbose logging, tracing is cheap enough for production speed and works in
+   * parallel mode, where each playout thread records into its own buffer.
+   *
+   * @param search_trace The trace to record into, or nullptr to disable
+   * tracing.
+   */
+  void set_trace(std::shared_ptr<Search_trace> search_trace);
+
+  /**
+   * @brief Replaces the agent's logger, e.g. to share one between the agents
+   * of a player, to redirect the output or to discard it with
+   * Logger::make_null_logger().
+   *
+   * @param search_logger The logger of the following searches.
+   * @throws std::invalid_argument if search_logger is nullptr.
+   */
+  void set_logger(std::shared_ptr<Logger> search_logger);
+
+  /**
+   * @brief Sets every tuning option of the following searches at once.
+   *
+   * The individual setters below change one option each and document it.
+   *
+   * @param search_options The options of the following searches.
+   * @throws std::invalid_argument if an option is out of range, see
+   * Search_options::validate().
+   */
+  void set_search_options(const Search_options& search_options);
+
+  /**
+   * @brief Getter for the tuning options of the following searches.
+   */
+  const Search_options& get_search_options() const;
+
+  /**
+   * @brief Sets the number of random moves after which a playout is cut off
+   * and scored with the static evaluation of evaluate_position().
+   *
+   * The winner of a cut-off playout is drawn with the evaluated win
+   * probability, so the win counts stay integral and unbiased. Short playouts
+   * with an evaluation are cheaper than complete random games on large boards
+   * and carry information about every route across the board.
+   *
+   * @param depth The number of random moves per playout, or 0 to always play
+   * the game to the end (the default).
+   * @throws std::invalid_argument if depth is negative.
+   */
+  void set_playout_cutoff_depth(int depth);
+
+  /**
+   * @brief Sets how the prior values of the children steer the selection.
+   *
+   * Each child starts with prior_visit_count virtual playouts won at the rate
+   * of its prior value, so the search can focus before every child has been
+   * played once, and a progressive-bias term weighted by
+   * progressive_bias_weight favours children with high prior values while
+   * fading with their real visits. Both default to 0, i.e. plain UCT.
+   *
+   * @param prior_visit_count The number of virtual playouts of each child.
+   * @param progressive_bias_weight The weight of the progressive-bias term.
+   * @throws std::invalid_argument if a parameter is negative.
+   */
+  void set_prior_knowledge(int prior_visit_count,
+                           double progressive_bias_weight);
+
+  /**
+   * @brief Enables progressive widening of the tree.
+   *
+   * The children of a node are sorted by decreasing prior value, and a node
+   * visited n times only selects among its first
+   * ceil(widening_constant * (n + 1)^widening_exponent) children, so the
+   * search concentrates on the most promising moves of large boards and
+   * admits the others as the node gathers visits.
+   *
+   * @param widening_constant The number of children selectable at the first
+   * visit, or 0 to select among all children (the default).
+   * @param widening_exponent The growth rate of the selectable children, e.g.
+   * 0.5 for a square-root growth.
+   * @throws std::invalid_argument if a parameter is negative.
+   */
+  void set_progressive_widening(double widening_constant,
+                                double widening_exponent);
+
+  /**
+   * @brief Sets the time limit of the following searches.
+   *
+   * @param max_decision_time The maximum time allowed for making a decision.
+   * @throws std::invalid_argument if max_decision_time is not positive.
+   */
+  void set_max_decision_time(std::chrono::milliseconds max_decision_time);
+
+  /**
+   * @brief Sets the policy that selects the child to play out, see
+   * selection_policy.h. The default is UCB1.
+   *
+   * @param policy The selection policy.
+   */
+  void set_selection_policy(Selection_policy_type policy);
+
+  /**
+   * @brief Sets how the move is chosen among the children of the root when
+   * the search ends.
+   *
+   * The win ratio of a lightly visited child is noisy, so the default of the
+   * highest win ratio can pick a move with a few lucky playouts. The most
+   * visited child is the one the selection trusted most, the robust-max child
+   * has both the most visits and the highest win ratio, and the secure child
+   * maximises the lower confidence bound of its win ratio, i.e. the ratio
+   * minus the exploration term of UCB1.
+   *
+   * @param criterion The final move criterion.
+   */
+  void set_final_move_criterion(Final_move_criterion criterion);
+
+  /**
+   * @brief Lets the search continue past the decision time while the most
+   * visited child and the child with the highest win ratio disagree.
+   *
+   * The search is extended in slices of a tenth of the decision time until
+   * the two children agree or the extension budget is spent. This keeps
+   * short decision times safe, as the extra time goes to the unsettled moves
+   * only.
+   *
+   * @param max_extension_ratio The longest extension as a multiple of the
+   * decision time, or 0 to never extend (the default).
+   * @throws std::invalid_argument if max_extension_ratio is negative.
+   */
+  void set_search_extension(double max_extension_ratio);
+
+  /**
+   * @brief Keeps the search exploring the best few moves of the root, so
+   * that each gets a stable value from one search.
+   *
+   * Selection at the root normally concentrates the playouts on the best
+   * move, leaving the runners-up too few visits to rank. In multi-PV mode,
+   * whenever one of the move_count visited children with the highest win
+   * ratio has less than half of an even share of the root visits, it is
+   * played out instead of the child chosen by the selection policy. The
+   * candidates are reported ranked in Search_analysis::top_moves. The final
+   * move criterion is unaffected.
+   *
+   * @param move_count The number of moves to keep exploring, 1 for the usual
+   * search (the default).
+   * @throws std::invalid_argument if move_count is smaller than 1.
+   */
+  void set_multi_pv(int move_count);
+
+  /**
+   * @brief Returns the counters and timers of the last search.
+   *
+   * The statistics cover the time spent in selection, expansion, simulation
+   * and backpropagation, the playouts per second, the number of nodes
+   * allocated, the tree depth reached and the utilisation of each playout
+   * thread. They are reset at the start of every call to choose_move.
+   *
+   * @return The statistics of the last completed search.
+   */
+  const Search_statistics& get_last_search_statistics() const;
+
+  /**
+   * @brief Returns the statistics of every child of the root after the last
+   * search, in the order the children were expanded.
+   *
+   * @return One entry per candidate move of the last searched position.
+   */
+  std::vector<Child_statistics> get_root_child_statistics() const;
+
+  /**
+   * @brief Returns the analysis of the last search: the chosen move and its
+   * value, the statistics of every child of the root, most visited first,
+   * the multi-PV candidates ranked by value and the counters and timers of
+   * the search.
+   *
+   * The analysis is collected from the tree on demand, so searches that do
+   * not ask for it cost nothing more. The selection scores are those the
+   * next selection at the root would compute; under Thompson sampling they
+   * are fresh samples.
+   *
+   * @return The analysis, with a best move of (-1, -1) before any search.
+   */
+  Search_analysis get_last_search_analysis() const;
+
  private:
   // Agent configuration parameters
   double exploration_factor;
@@ -105,13 +332,36 @@ class Mcts_agent {
   // For logging
   std::shared_ptr<Logger> logger;
 
-  // For random number generation
-  std::random_device random_device;
-  std::mt19937 random_generator;
+  // For structured tracing; nullptr when disabled
+  std::shared_ptr<Search_trace> trace;
+  // The iteration being performed, as recorded in the trace
+  int current_iteration = 0;
+
+  // The tuning options of the searches, see set_search_options()
+  Search_options options;
+
+  // The win ratios of the first moves by board size, see
+  // get_first_move_values()
+  std::map<int, std::vector<double>> first_move_values;
+
+  // Counters and timers of the current or last search
+  Search_statistics statistics;
+  // The move chosen by the last search
+  std::pair<int, int> last_best_move{-1, -1};
 
   // The root node of the game tree
   struct Node;
   std::shared_ptr<Node> root;
+  // The position the root belongs to, so that a search of the same position
+  // can continue on the tree
+  int root_board_size = 0;
+  std::uint64_t root_hash = 0;
+  // Whether the children of the root were given prior values
+  bool root_has_priors = false;
+
+  // The playout threads in parallel mode, kept for the agent's lifetime;
+  // nullptr otherwise
+  std::unique_ptr<Thread_pool> thread_pool;
 
   /**
    * @brief A nested structure representing a node in the search tree for Monte
@@ -144,6 +394,13 @@ class Mcts_agent {
      * coordinates on a game board.
      */
     std::pair<int, int> move;
+    /**
+     * @brief The prior knowledge of the node's move for the player who made
+     * it, between 0 and 1: the mean of the static evaluation of the resulting
+     * state and the heuristic score of the move. It orders the children at
+     * expansion and seeds their statistics in selection.
+     */
+    double prior_value;
     /**
      * @brief The player who made the move from the parent node's state to this
      * node's state (Cell_state).
@@ -184,6 +441,21 @@ class Mcts_agent {
          std::shared_ptr<Node> parent_node = nullptr);
   };
 
+  /**
+   * @brief Returns the win ratios of every first move on an empty board, for
+   * the player making the first move.
+   *
+   * The table is computed on the first call for a board size with a quick
+   * search by a private agent of the same configuration, borrowing the
+   * playout threads, and cached for the lifetime of the agent. The statistics
+   * of a move and its 180 degree rotation are pooled.
+   *
+   * @param board_size The size of the board.
+   * @return The win ratios indexed by row * board_size + column. Moves that
+   * were never visited have a neutral value of 0.5.
+   */
+  const std::vector<double>& get_first_move_values(int board_size);
+
   /**
    * @brief Expands a given node by generating all its possible child nodes
    * based on the valid moves on the current game board.
@@ -191,6 +463,11 @@ class Mcts_agent {
    * This function populates the `child_nodes` member of the input `Node` with
    * new nodes, each representing a valid move for the player at the current
    * game state. Each child node is linked back to the input node as its parent.
+   * Moves ruled out by Inferior_cell_analysis (dead and captured cells, or all
+   * but the forced moves) get no child. If uses_priors(), the prior value of
+   * each child comes from evaluate_position() and get_move_heuristic(), and
+   * the children are sorted by decreasing prior value. Otherwise every child
+   * keeps the neutral prior value of 0.5.
    *
    * If verbose mode is enabled, the function will also print information about
    * each new child node it creates.
@@ -200,21 +477,37 @@ class Mcts_agent {
    */
   void expand_node(const std::shared_ptr<Node>& node, const Board& board);
 
+  /**
+   * @brief Checks whether the configuration reads the prior values of the
+   * children: prior knowledge, progressive widening or PUCT selection.
+   */
+  bool uses_priors() const;
+
+  /**
+   * @brief Returns the number of children of a node that selection considers
+   * under progressive widening.
+   *
+   * @param node The node whose children are selected from.
+   * @return The number of leading children of the node, in prior order, that
+   * can be selected.
+   */
+  std::size_t get_selectable_child_count(const Node& node) const;
+
   /**
    * @brief Performs the main loop of the Monte Carlo Tree Search (MCTS)
    * algorithm.
    *
    * This function performs multiple iterations of the MCTS algorithm until a
    * provided end time is reached. In each iteration, a child node is selected
-   * from the root node using the UCT score, and a playout is simulated from
-   * this node, either in parallel or serially depending on the value of
+   * from the root node using the selection policy, and a playout is simulated
+   * from this node, either in parallel or serially depending on the value of
    * `is_parallelized`. The results of the playout are then backpropagated up
    * the MCTS tree. The function also logs various statistics of the root node
    * and its children after each iteration using the Logger class.
    *
    * @param end_time The end time for the MCTS iterations. The function will
    * continue performing iterations until the current time is greater than this
-   * value.
+   * value, after at least one iteration if the root was never visited.
    * @param mcts_iteration_counter A reference to an integer counter for the
    * number of MCTS iterations performed so far. This counter is incremented
    * after each iteration.
@@ -229,43 +522,93 @@ class Mcts_agent {
       unsigned int number_of_threads);
 
   /**
-   * @brief Selects the best child of a given parent node based on the Upper
-   * Confidence Bound for Trees (UCT) score.
+   * @brief Selects the best child of a given parent node based on the score
+   * of the agent's selection policy, UCB1 (the UCT score) by default.
    *
-   * This function iterates through all the child nodes of the given parent
-   * node, and for each child, calculates its UCT score using the
-   * calculate_uct_score() method. The child with the highest UCT score is
-   * selected as the best child. If verbose mode is enabled, the function prints
-   * the move coordinates and the UCT score of the selected child.
+   * This function iterates through the child nodes of the given parent node
+   * that progressive widening admits, and for each child, calculates its
+   * score using the calculate_selection_score() method. The child with the
+   * highest score is selected as the best child. If verbose mode is enabled,
+   * the function prints the move coordinates and the score of the selected
+   * child.
    *
    * @param parent_node A shared_ptr to the parent Node whose child nodes are to
    * be evaluated.
    * @return A shared_ptr to the Node that is selected as the best child.
+   * @throws std::runtime_error If the node has no children.
    */
   std::shared_ptr<Node> select_child_for_playout(
       const std::shared_ptr<Node>& parent_node);
 
   /**
-   * @brief Calculates the Upper Confidence Bound for Trees (UCT) score for a
-   * given node.
+   * @brief Returns the multi-PV candidate of the root that most needs
+   * visits, see set_multi_pv().
+   *
+   * @return The least visited of the multi_pv_count visited children with
+   * the highest win ratio if it has less than half of an even share of the
+   * root visits, else nullptr to let the selection policy choose.
+   */
+  std::shared_ptr<Node> select_multi_pv_candidate() const;
+
+  /**
+   * @brief Returns the indices of the multi_pv_count visited children of the
+   * root with the highest win ratio, ranked, or fewer if fewer were visited.
+   */
+  std::vector<std::size_t> get_multi_pv_candidates() const;
+
+  /**
+   * @brief Selects the child with the highest score under a selection policy.
+   *
+   * Instantiated once per policy by select_child_for_playout(), so the score
+   * of the policy is inlined into the loop over the children.
+   *
+   * @tparam Policy One of the policies of selection_policy.h.
+   * @param parent_node The node whose child nodes are to be evaluated.
+   * @return The selected child.
+   * @throws std::runtime_error If the node has no children, e.g. because the
+   * board is full.
+   */
+  template <typename Policy>
+  std::shared_ptr<Node> select_child_with_policy(
+      const std::shared_ptr<Node>& parent_node);
+
+  /**
+   * @brief Calculates the selection score of a child under a selection
+   * policy.
    *
-   * The UCT score is used in the selection phase of the Monte Carlo Tree Search
-   * (MCTS) algorithm to balance the exploration and exploitation trade-off. The
-   * function uses the UCT formula, which is a sum of the exploitation term (win
-   * ratio) and the exploration term. The exploration term is proportional to
-   * the square root of the logarithm of the parent node's visit count divided
-   * by the child node's visit count.
+   * The policy balances exploration and exploitation from the child's win and
+   * visit counts, which include the virtual playouts of the prior, and its
+   * prior value. The progressive-bias term, proportional to the prior value
+   * divided by one more than the real visit count, is added to the score of
+   * every policy. Under UCB1 and UCB1-Tuned, a child without any visit gets
+   * the highest possible score to encourage exploration.
    *
-   * The function returns a high value if the child node has not been visited
-   * yet, to encourage the exploration of unvisited nodes.
+   * @tparam Policy One of the policies of selection_policy.h.
+   * @param child_node The child whose score is being calculated.
+   * @param context The values shared by all children of the parent.
+   * @return The calculated score.
+   */
+  template <typename Policy>
+  double calculate_selection_score(const Node& child_node,
+                                   const Selection_context& context) const;
+
+  /**
+   * @brief Collects the values shared by the selectable children of a node
+   * for the selection policies.
    *
-   * @param child_node A shared_ptr to the child Node for which the UCT score is
-   * being calculated.
-   * @param parent_node A shared_ptr to the parent Node of the child node.
-   * @return The calculated UCT score.
+   * @param parent_node The node whose children are scored.
+   * @param selectable_child_count The number of children admitted by
+   * progressive widening, see get_selectable_child_count().
+   */
+  Selection_context make_selection_context(
+      const Node& parent_node, std::size_t selectable_child_count) const;
+
+  /**
+   * @brief Calculates the selection score of a child under the agent's
+   * selection policy, for reporting rather than the selection loop.
    */
-  double calculate_uct_score(const std::shared_ptr<Node>& child_node,
-                             const std::shared_ptr<Node>& parent_node);
+  double get_selection_score(const Node& child_node,
+                             const Selection_context& context) const;
 
   /**
    * @brief Simulates a random playout from a given node on a given board.
@@ -273,27 +616,34 @@ class Mcts_agent {
    * This function takes as input a node and a board state, and simulates a
    * random playout starting from the node's move. The simulation proceeds by
    * alternating between players, choosing a random valid move for each player,
-   * until the game ends (i.e., when a player wins). If verbose mode is enabled,
+   * until the game ends (i.e., when a player wins) or the playout cutoff depth
+   * is reached. In the latter case, the winner is drawn with the probability
+   * given by evaluate_position(). If verbose mode is enabled,
    * the function also prints information about the simulation, including the
    * move made at each step and the state of the board and its state using
-   * Logger.
+   * Logger. Random moves are drawn from the thread-local Random_generator, so
+   * concurrent playouts neither share nor lock a generator.
    *
    * @param node A shared_ptr to the Node from which the simulation starts.
    * @param board The Board on which the simulation is conducted. The board
    * state is copied, so the original board is not modified.
+   * @param thread_index The index of the calling playout thread, used to pick
+   * its buffer in the search trace.
    * @return The Cell_state of the winning player.
    */
   Cell_state simulate_random_playout(const std::shared_ptr<Node>& node,
-                                     Board board);
+                                     Board board,
+                                     unsigned int thread_index = 0);
 
   /**
    * @brief Performs a number of game playouts in parallel from a given node and
    * returns their results.
    *
    * This function simulates several game playouts starting from a given node in
-   * parallel using multiple threads. It returns the outcome of each playout in
-   * a vector, with the result of the playout simulated by the i-th thread
-   * stored in the i-th position of the vector.
+   * parallel on the threads of the agent's Thread_pool, which are started once
+   * with the agent. It returns the outcome of each playout in a vector, with
+   * the result of the playout simulated by the i-th thread stored in the i-th
+   * position of the vector.
    *
    * @param node The node from which the playouts should be simulated.
    * @param board The current state of the game board.
@@ -327,22 +677,50 @@ class Mcts_agent {
   void backpropagate(std::shared_ptr<Node>& node, Cell_state winner);
 
   /**
-   * @brief Selects the best child of the root node based on the highest win
-   * ratio.
+   * @brief Returns the win ratio of a child, i.e. its win count divided by
+   * its visit count, both including the virtual playouts of the prior, or 0
+   * if the child has neither real nor virtual visits.
+   */
+  double get_child_value(const Node& child_node) const;
+
+  /**
+   * @brief Returns the visited child of the root with the highest score, the
+   * first one on ties, or nullptr if no child was visited.
+   *
+   * @param score A function from a child node to its score.
+   * @param max_score If not nullptr, receives the score of the returned child.
+   */
+  template <typename Score>
+  std::shared_ptr<Node> find_highest_scoring_child(
+      Score score, double* max_score = nullptr) const;
+
+  /**
+   * @brief Checks whether the most visited child of the root also has the
+   * highest win ratio, which ends a search extension.
+   */
+  bool is_search_settled() const;
+
+  /**
+   * @brief Selects the best child of the root node by the final move
+   * criterion.
    *
-   * This function iterates over the root's child nodes, calculates the win
-   * ratio for each child node (i.e., the child node's win count divided by its
-   * visit count), and returns the child node with the highest win ratio. If
-   * verbose mode is enabled, it logs the win ratio for each child node. If no
-   * child node can be selected due to insufficient statistics (which might
-   * occur if the agent was given too little decision time for the board size),
-   * it throws a runtime error.
+   * This function scores the visited children of the root by the criterion,
+   * see set_final_move_criterion(), and returns the child with the highest
+   * score. Children that were never visited, e.g. beyond the progressive
+   * widening, are not candidates. If verbose mode is enabled, it logs the win
+   * ratio for each child node. If no child node can be selected due to
+   * insufficient statistics (which might occur if the agent was given too
+   * little decision time for the board size), it throws a runtime error.
    *
-   * @return A shared pointer to the child node with the highest win ratio.
+   * @param score_name Receives the name of the score the criterion compared.
+   * @param best_score Receives that score of the best child, e.g. its win
+   * ratio including the virtual playouts of the prior.
+   * @return A shared pointer to the best child node.
    * @throws std::runtime_error If no child can be selected due to insufficient
    * statistics.
    */
-  std::shared_ptr<Node> select_best_child();
+  std::shared_ptr<Node> select_best_child(std::string& score_name,
+                                          double& best_score);
 };
 
 #endif
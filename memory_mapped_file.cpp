@@ -0,0 +1,101 @@
+#include "memory_mapped_file.h"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+Memory_mapped_file::Memory_mapped_file(const std::string& path) {
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    throw std::runtime_error("Cannot open " + path + ".");
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    throw std::runtime_error("Cannot read the size of " + path + ".");
+  }
+  size = static_cast<std::size_t>(file_size.QuadPart);
+  if (size > 0) {
+    HANDLE mapping =
+        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+      data = static_cast<const std::uint8_t*>(
+          MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+      // The view keeps the mapping alive
+      CloseHandle(mapping);
+    }
+  }
+  CloseHandle(file);
+#else
+  int file = open(path.c_str(), O_RDONLY);
+  if (file < 0) {
+    throw std::runtime_error("Cannot open " + path + ".");
+  }
+  struct stat file_status;
+  if (fstat(file, &file_status) != 0) {
+    close(file);
+    throw std::runtime_error("Cannot read the size of " + path + ".");
+  }
+  size = static_cast<std::size_t>(file_status.st_size);
+  if (size > 0) {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (mapping != MAP_FAILED) {
+      data = static_cast<const std::uint8_t*>(mapping);
+    }
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(file);
+#endif
+  if (size > 0 && !data) {
+    throw std::runtime_error("Cannot map " + path + " into memory.");
+  }
+}
+
+Memory_mapped_file::~Memory_mapped_file() { unmap(); }
+
+Memory_mapped_file::Memory_mapped_file(Memory_mapped_file&& other) noexcept
+    : data(other.data), size(other.size) {
+  other.data = nullptr;
+  other.size = 0;
+}
+
+Memory_mapped_file& Memory_mapped_file::operator=(
+    Memory_mapped_file&& other) noexcept {
+  if (this != &other) {
+    unmap();
+    data = other.data;
+    size = other.size;
+    other.data = nullptr;
+    other.size = 0;
+  }
+  return *this;
+}
+
+const std::uint8_t* Memory_mapped_file::get_data() const { return data; }
+
+std::size_t Memory_mapped_file::get_size() const { return size; }
+
+void Memory_mapped_file::unmap() {
+  if (!data) return;
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+#else
+  munmap(const_cast<std::uint8_t*>(data), size);
+#endif
+  data = nullptr;
+  size = 0;
+}
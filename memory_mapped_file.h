@@ -0,0 +1,56 @@
+#ifndef MEMORY_MAPPED_FILE_H
+#define MEMORY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class Memory_mapped_file
+ *
+ * @brief A read-only memory mapping of a whole file.
+ *
+ * The file is mapped on construction and unmapped on destruction, so its
+ * contents can be read in place without copying them into the process. Uses
+ * mmap on POSIX systems and file mappings on Windows.
+ *
+ * The class is movable but not copyable.
+ */
+class Memory_mapped_file {
+ public:
+  /**
+   * @brief Maps a file into memory for reading.
+   *
+   * @param path The path of the file.
+   * @throws std::runtime_error if the file cannot be opened or mapped.
+   */
+  explicit Memory_mapped_file(const std::string& path);
+  ~Memory_mapped_file();
+
+  // Non-copyable, but movable
+  Memory_mapped_file(const Memory_mapped_file&) = delete;
+  Memory_mapped_file& operator=(const Memory_mapped_file&) = delete;
+  Memory_mapped_file(Memory_mapped_file&& other) noexcept;
+  Memory_mapped_file& operator=(Memory_mapped_file&& other) noexcept;
+
+  /**
+   * @brief Returns the first byte of the mapped file, nullptr if it is empty.
+   */
+  const std::uint8_t* get_data() const;
+
+  /**
+   * @brief Returns the size of the mapped file in bytes.
+   */
+  std::size_t get_size() const;
+
+ private:
+  const std::uint8_t* data = nullptr;
+  std::size_t size = 0;
+
+  /**
+   * @brief Releases the mapping, if any.
+   */
+  void unmap();
+};
+
+#endif  // MEMORY_MAPPED_FILE_H
@@ -0,0 +1,161 @@
+#include "opening_book.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_set>
+#include <vector>
+
+#include "mcts_agent.h"
+
+namespace {
+
+const char book_magic[4] = {'H', 'E', 'X', 'B'};
+const std::uint16_t book_format_version = 2;
+// Magic, version, board size and entry count
+const std::size_t book_header_size = 16;
+
+}  // namespace
+
+Opening_book::Opening_book(const std::string& path) : file(path) {
+  const std::uint8_t* data = file.get_data();
+  if (file.get_size() < book_header_size ||
+      std::memcmp(data, book_magic, sizeof(book_magic)) != 0) {
+    throw std::runtime_error(path + " is not an opening book.");
+  }
+  std::uint16_t version;
+  std::uint16_t size_field;
+  std::uint64_t count_field;
+  std::memcpy(&version, data + 4, sizeof(version));
+  std::memcpy(&size_field, data + 6, sizeof(size_field));
+  std::memcpy(&count_field, data + 8, sizeof(count_field));
+  if (version != book_format_version) {
+    throw std::runtime_error("Unsupported opening book version.");
+  }
+  board_size = size_field;
+  entry_count = static_cast<std::size_t>(count_field);
+  if ((file.get_size() - book_header_size) / sizeof(Opening_book_entry) <
+      entry_count) {
+    throw std::runtime_error(path + " is truncated or corrupted.");
+  }
+  // The mapping is page-aligned and the header keeps the entries aligned
+  entries =
+      reinterpret_cast<const Opening_book_entry*>(data + book_header_size);
+}
+
+int Opening_book::get_board_size() const { return board_size; }
+
+std::size_t Opening_book::size() const { return entry_count; }
+
+bool Opening_book::lookup(const Board& board, Cell_state player,
+                          std::pair<int, int>& move) const {
+  if (board.get_board_size() != board_size) return false;
+  const std::uint64_t key = get_key(board, player);
+  const Board_symmetry symmetry = board.get_canonical_symmetry(player);
+  const Opening_book_entry* entry = std::lower_bound(
+      entries, entries + entry_count, key,
+      [](const Opening_book_entry& book_entry, std::uint64_t searched_key) {
+        return book_entry.key < searched_key;
+      });
+  if (entry == entries + entry_count || entry->key != key) return false;
+  // The stored move belongs to the canonical form of the position
+  const std::pair<int, int> book_move = board.transform_cell(
+      std::make_pair(entry->move_x, entry->move_y), symmetry);
+  if (!board.is_valid_move(book_move.first, book_move.second)) return false;
+  move = book_move;
+  return true;
+}
+
+std::uint64_t Opening_book::get_key(const Board& board, Cell_state player) {
+  return board.get_canonical_hash(player);
+}
+
+void Opening_book::build(const std::string& path, int board_size, int max_ply,
+                         double exploration_factor,
+                         std::chrono::milliseconds time_per_position,
+                         bool is_parallelized) {
+  Mcts_agent agent(exploration_factor, time_per_position, is_parallelized);
+  std::vector<Opening_book_entry> book_entries;
+  std::unordered_set<std::uint64_t> searched_keys;
+  // Positions to search at the current ply and the one after it
+  std::vector<Board> positions{Board(board_size)};
+  std::vector<Board> next_positions;
+  for (int ply = 0; ply < max_ply; ++ply) {
+    Cell_state player = ply % 2 == 0 ? Cell_state::Blue : Cell_state::Red;
+    Cell_state opponent = ply % 2 == 0 ? Cell_state::Red : Cell_state::Blue;
+    std::vector<Board> positions_after_next;
+    for (const Board& position : positions) {
+      const std::uint64_t key = get_key(position, player);
+      if (position.get_valid_moves().empty() ||
+          !searched_keys.insert(key).second) {
+        continue;
+      }
+      std::cout << "Searching position " << book_entries.size() + 1
+                << " at ply " << ply << "..." << std::endl;
+      std::pair<int, int> best_move = agent.choose_move(position, player);
+      Opening_book_entry entry{key, 0.f, 0, 0, 0, 0};
+      for (const auto& child : agent.get_root_child_statistics()) {
+        if (child.move == best_move) {
+          entry.win_ratio = static_cast<float>(child.get_win_ratio());
+          entry.visit_count = static_cast<std::uint32_t>(child.visit_count);
+        }
+      }
+      const std::pair<int, int> canonical_move = position.transform_cell(
+          best_move, position.get_canonical_symmetry(player));
+      entry.move_x = static_cast<std::int16_t>(canonical_move.first);
+      entry.move_y = static_cast<std::int16_t>(canonical_move.second);
+      book_entries.push_back(entry);
+      // The opponent may answer anything: the book player meets every
+      // reply two plies later.
+      Board after_book_move = position;
+      if (after_book_move.make_move(best_move.first, best_move.second,
+                                    player) != Cell_state::Empty) {
+        continue;
+      }
+      for (const auto& reply : after_book_move.get_valid_moves()) {
+        Board after_reply = after_book_move;
+        after_reply.make_move(reply.first, reply.second, opponent);
+        positions_after_next.push_back(after_reply);
+      }
+    }
+    // At the first ply, the opponent also uses the book after any first move
+    if (ply == 0) {
+      for (const auto& first_move : positions.front().get_valid_moves()) {
+        Board after_first_move = positions.front();
+        after_first_move.make_move(first_move.first, first_move.second,
+                                   player);
+        next_positions.push_back(after_first_move);
+      }
+    }
+    positions = std::move(next_positions);
+    next_positions = std::move(positions_after_next);
+  }
+
+  std::sort(book_entries.begin(), book_entries.end(),
+            [](const Opening_book_entry& first,
+               const Opening_book_entry& second) {
+              return first.key < second.key;
+            });
+  std::ofstream book_file(path, std::ios::binary | std::ios::trunc);
+  if (!book_file) {
+    throw std::runtime_error("Cannot create " + path + ".");
+  }
+  const std::uint16_t size_field = static_cast<std::uint16_t>(board_size);
+  const std::uint64_t count_field = book_entries.size();
+  book_file.write(book_magic, sizeof(book_magic));
+  book_file.write(reinterpret_cast<const char*>(&book_format_version),
+                  sizeof(book_format_version));
+  book_file.write(reinterpret_cast<const char*>(&size_field),
+                  sizeof(size_field));
+  book_file.write(reinterpret_cast<const char*>(&count_field),
+                  sizeof(count_field));
+  book_file.write(
+      reinterpret_cast<const char*>(book_entries.data()),
+      static_cast<std::streamsize>(book_entries.size() *
+                                   sizeof(Opening_book_entry)));
+  if (!book_file) {
+    throw std::runtime_error("Cannot write " + path + ".");
+  }
+}
@@ -0,0 +1,119 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "board.h"
+#include "cell_state.h"
+#include "memory_mapped_file.h"
+
+/**
+ * @struct Opening_book_entry
+ * @brief The precomputed best move of one position, as stored in the book.
+ */
+struct Opening_book_entry {
+  std::uint64_t key;           ///< Opening_book::get_key() of the position.
+  float win_ratio;             ///< Win ratio of the move in the search.
+  std::uint32_t visit_count;   ///< Visits of the move in the search.
+  std::int16_t move_x;         ///< Row of the best move, canonical form.
+  std::int16_t move_y;         ///< Column of the best move, canonical form.
+  std::uint32_t reserved;      ///< Padding, always 0.
+};
+
+static_assert(sizeof(Opening_book_entry) == 24,
+              "Opening book files rely on a 24-byte entry.");
+
+/**
+ * @class Opening_book
+ *
+ * @brief A memory-mapped table of precomputed best moves for the first plies
+ * of a game.
+ *
+ * The results of the opening searches are the same in every game, so they are
+ * computed once by build() with long Mcts_agent searches and stored in a file.
+ * Mcts_player consults the book before searching, and a hit costs a binary
+ * search over the mapped entries instead of a full search. Positions are
+ * stored once per class of symmetric positions, under their canonical hash
+ * and with the move of their canonical form, so a book of the same size
+ * covers up to four times as many positions.
+ *
+ * File layout: the magic "HEXB", the format version and the board size as
+ * 16-bit integers, the number of entries as a 64-bit integer, then the
+ * entries sorted by key. Integers use the byte order of the machine that
+ * wrote the file.
+ */
+class Opening_book {
+ public:
+  /**
+   * @brief Opens and maps an opening book file.
+   *
+   * @param path The path of the file.
+   * @throws std::runtime_error if the file cannot be mapped or is not a valid
+   * opening book.
+   */
+  explicit Opening_book(const std::string& path);
+
+  /**
+   * @brief Getter for the board size the book was built for.
+   */
+  int get_board_size() const;
+
+  /**
+   * @brief Returns the number of positions in the book.
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Looks up the best move of a position.
+   *
+   * @param board The current state of the game board.
+   * @param player The player to move.
+   * @param move Receives the book move if the position is found.
+   * @return True if the book contains a legal move for the position.
+   */
+  bool lookup(const Board& board, Cell_state player,
+              std::pair<int, int>& move) const;
+
+  /**
+   * @brief Computes the key of a position in the book.
+   *
+   * @param board The state of the game board.
+   * @param player The player to move.
+   * @return The canonical hash of the position, see
+   * Board::get_canonical_hash().
+   */
+  static std::uint64_t get_key(const Board& board, Cell_state player);
+
+  /**
+   * @brief Builds an opening book with Mcts_agent searches and writes it to a
+   * file.
+   *
+   * The book covers, up to max_ply plies, the positions that a player
+   * following the book can face: the empty board, every first move, and,
+   * recursively, every reply to a book move two plies earlier.
+   *
+   * @param path The path of the file to write.
+   * @param board_size The size of the board.
+   * @param max_ply The number of plies covered; 2 covers the first move of
+   * both players.
+   * @param exploration_factor The exploration factor of the searches.
+   * @param time_per_position The search time of each position.
+   * @param is_parallelized Whether the searches run parallel playouts.
+   * @throws std::runtime_error if the file cannot be written.
+   */
+  static void build(const std::string& path, int board_size, int max_ply,
+                    double exploration_factor,
+                    std::chrono::milliseconds time_per_position,
+                    bool is_parallelized);
+
+ private:
+  Memory_mapped_file file;
+  int board_size;
+  std::size_t entry_count;
+  const Opening_book_entry* entries;
+};
+
+#endif  // OPENING_BOOK_H
@@ -2,7 +2,10 @@
 
 #include <chrono>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 
+#include "console_interface.h"
 #include "mcts_agent.h"
 
 std::pair<int, int> Human_player::choose_move(const Board& board,
@@ -40,19 +43,69 @@ std::pair<int, int> Human_player::choose_move(const Board& board,
   return std::make_pair(-1, -1);  // should never reach this
 }
 
+bool Human_player::choose_swap(const Board& board,
+                               const std::pair<int, int>& first_move,
+                               Cell_state player) {
+  return get_yes_or_no_response(
+             "Would you like to swap and take over the first move? (y/n): ") ==
+         'y';
+}
+
 Mcts_player::Mcts_player(double exploration_factor,
                          std::chrono::milliseconds max_decision_time,
                          bool is_parallelized, bool is_verbose)
     : exploration_factor(exploration_factor),
       max_decision_time(max_decision_time),
       is_parallelized(is_parallelized),
-      is_verbose(is_verbose) {}
+      is_verbose(is_verbose),
+      logger(std::make_shared<Logger>(is_verbose)) {}
 
 std::pair<int, int> Mcts_player::choose_move(const Board& board,
                                              Cell_state player) {
+  std::pair<int, int> book_move;
+  if (opening_book && opening_book->lookup(board, player, book_move)) {
+    return book_move;
+  }
+  Mcts_agent agent(exploration_factor, max_decision_time, is_parallelized,
+                   is_verbose);
+  agent.set_logger(logger);
+  agent.set_trace(trace);
+  agent.set_search_options(search_options);
+  std::pair<int, int> move = agent.choose_move(board, player);
+  if (trace) {
+    trace->save_to_file(trace_path);
+  }
+  return move;
+}
+
+bool Mcts_player::choose_swap(const Board& board,
+                              const std::pair<int, int>& first_move,
+                              Cell_state player) {
   Mcts_agent agent(exploration_factor, max_decision_time, is_parallelized,
                    is_verbose);
-  return agent.choose_move(board, player);
+  agent.set_logger(logger);
+  agent.set_search_options(search_options);
+  return agent.choose_swap(board, first_move);
 }
 
-bool Mcts_player::get_is_verbose() const { return is_verbose; }
\ No newline at end of file
+void Mcts_player::set_is_rendering(bool is_rendering) {
+  if (is_verbose) return;
+  logger = is_rendering ? std::make_shared<Logger>(false)
+                        : Logger::make_null_logger();
+}
+
+bool Mcts_player::get_is_verbose() const { return is_verbose; }
+
+void Mcts_player::set_trace_file(const std::string& path) {
+  trace = std::make_shared<Search_trace>();
+  trace_path = path;
+}
+
+void Mcts_player::set_opening_book(std::shared_ptr<const Opening_book> book) {
+  opening_book = std::move(book);
+}
+
+void Mcts_player::set_search_options(const Search_options& options) {
+  options.validate();
+  search_options = options;
+}
@@ -2,9 +2,15 @@
 #define PLAYER_H
 
 #include <chrono>
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "board.h"
+#include "logger.h"
+#include "opening_book.h"
+#include "search_options.h"
+#include "search_trace.h"
 
 /**
  * @brief Player serves as an abstract base class providing a contract for all
@@ -15,7 +21,9 @@
  *
  * A Player's primary responsibility is to choose a move based on the current
  * state of the game board. This interaction is modelled via the pure virtual
- * function choose_move().
+ * function choose_move(). When the game is played with the swap (pie) rule,
+ * the second player also decides via choose_swap() whether to take over the
+ * first move instead of replying to it.
  */
 class Player {
  public:
@@ -27,6 +35,33 @@ class Player {
    */
   virtual std::pair<int, int> choose_move(const Board& board,
                                           Cell_state player) = 0;
+
+  /**
+   * @brief Abstract function for deciding whether to apply the swap rule.
+   *
+   * Called once for the second player after the first move when the game is
+   * played with the swap rule. Swapping replaces the first stone by a stone of
+   * the second player at the mirrored cell (row and column exchanged), after
+   * which the first player moves again.
+   *
+   * @param board Current state of the game board, holding only the first
+   * move.
+   * @param first_move The first move of the game.
+   * @param player The player who may swap (Cell_state).
+   * @return True to swap, false to reply to the first move.
+   */
+  virtual bool choose_swap(const Board& board,
+                           const std::pair<int, int>& first_move,
+                           Cell_state player) = 0;
+
+  /**
+   * @brief Tells the player whether its game is printed. A player of a
+   * headless game prints no progress messages of its own. Does nothing by
+   * default.
+   *
+   * @param is_rendering False if the game prints nothing.
+   */
+  virtual void set_is_rendering(bool is_rendering) {}
 };
 
 /**
@@ -52,6 +87,18 @@ class Human_player : public Player {
    */
   std::pair<int, int> choose_move(const Board& board,
                                   Cell_state player) override;
+
+  /**
+   * @brief Implementation of the choose_swap function for the Human_player
+   * class. This function asks the user whether to swap.
+   *
+   * @param board The current state of the game board (Board).
+   * @param first_move The first move of the game.
+   * @param player The current player (Cell_state).
+   * @return True if the user chooses to swap.
+   */
+  bool choose_swap(const Board& board, const std::pair<int, int>& first_move,
+                   Cell_state player) override;
 };
 
 /**
@@ -75,7 +122,8 @@ class Mcts_player : public Player {
    * @param exploration_factor The exploration factor used in MCTS.
    * @param max_decision_time The maximum time allowed for decision making.
    * @param is_parallelized If true, MCTS computations are parallelized.
-   * @param is_verbose If true, verbose logging is enabled.
+   * @param is_verbose If true, verbose logging is enabled. The agents of the
+   * player share one Logger of this verbosity, independent of other players.
    */
   Mcts_player(double exploration_factor,
               std::chrono::milliseconds max_decision_time,
@@ -83,8 +131,10 @@ class Mcts_player : public Player {
 
   /**
    * @brief Implementation of the choose_move function for the Mcts_player
-   * class. This function uses the MCTS agent to choose a move. New instances of
-   * the agent are created for each move, so the agent's tree is not preserved.
+   * class. If an opening book is set and contains the position, the book move
+   * is played without searching. Otherwise, this function uses the MCTS agent
+   * to choose a move. New instances of the agent are created for each move, so
+   * the agent's tree is not preserved.
    *
    * @param board The current state of the game board.
    * @param player The current player.
@@ -93,6 +143,28 @@ class Mcts_player : public Player {
   std::pair<int, int> choose_move(const Board& board,
                                   Cell_state player) override;
 
+  /**
+   * @brief Implementation of the choose_swap function for the Mcts_player
+   * class. The decision is made by Mcts_agent::choose_swap() from a table of
+   * first-move values, without a full-budget search.
+   *
+   * @param board The current state of the game board.
+   * @param first_move The first move of the game.
+   * @param player The current player.
+   * @return True if swapping is expected to be better than replying.
+   */
+  bool choose_swap(const Board& board, const std::pair<int, int>& first_move,
+                   Cell_state player) override;
+
+  /**
+   * @brief Silences the "Thinking silently..." message of a non-verbose
+   * player in a headless game by giving its agents a null Logger. The
+   * verbose logs of a verbose player are kept, as they were asked for.
+   *
+   * @param is_rendering False if the game prints nothing.
+   */
+  void set_is_rendering(bool is_rendering) override;
+
   /**
    * @brief Getter for the is_verbose private member of the Mcts_player class.
    *
@@ -100,11 +172,44 @@ class Mcts_player : public Player {
    */
   bool get_is_verbose() const;
 
+  /**
+   * @brief Enables binary search tracing for every move of this player.
+   *
+   * The searches of all moves are recorded into one Search_trace, which is
+   * written to the given file after each move so that it is complete whenever
+   * the game stops. The file can be rendered with the trace_dump tool.
+   *
+   * @param path The path of the trace file.
+   */
+  void set_trace_file(const std::string& path);
+
+  /**
+   * @brief Sets the opening book consulted before each search.
+   *
+   * @param book The opening book, or nullptr to always search. The book may be
+   * shared between players.
+   */
+  void set_opening_book(std::shared_ptr<const Opening_book> book);
+
+  /**
+   * @brief Sets the tuning options of the agent's searches, see
+   * Mcts_agent::set_search_options().
+   *
+   * @param options The options of every following search.
+   * @throws std::invalid_argument if an option is out of range.
+   */
+  void set_search_options(const Search_options& options);
+
  private:
   double exploration_factor;  // The exploration factor used in MCTS.
   std::chrono::milliseconds max_decision_time;  // Maximum decision-making time.
   bool is_parallelized;  // If true, MCTS computations are parallelized.
   bool is_verbose;       // If true, enables verbose logging to console.
+  std::shared_ptr<Logger> logger;  // Shared by the agents of the player.
+  std::shared_ptr<Search_trace> trace;  // Search trace, nullptr if disabled.
+  std::string trace_path;               // File the search trace is saved to.
+  std::shared_ptr<const Opening_book> opening_book;  // nullptr if unused.
+  Search_options search_options;  // Applied to every agent of the player.
 };
 
 #endif
\ No newline at end of file
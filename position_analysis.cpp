@@ -0,0 +1,87 @@
+#include "position_analysis.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "game_record.h"
+#include "logger.h"
+#include "mcts_agent.h"
+
+namespace {
+
+/**
+ * @brief Quotes a string as a JSON string literal.
+ */
+std::string to_json_string(const std::string& text) {
+  std::ostringstream json;
+  json << '"';
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      json << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      json << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+           << static_cast<int>(c) << std::dec;
+    } else {
+      json << c;
+    }
+  }
+  json << '"';
+  return json.str();
+}
+
+}  // namespace
+
+std::string analyze_position(const std::string& id, const Board& board,
+                             Cell_state player_to_move,
+                             std::chrono::milliseconds search_time,
+                             std::size_t max_child_count) {
+  if (board.check_winner() != Cell_state::Empty) {
+    throw std::invalid_argument("The game is over.");
+  }
+  Mcts_agent agent(1.41, search_time, false);
+  agent.set_logger(Logger::make_null_logger());
+  // A limited number of children is searched and reported as multi-PV
+  const bool is_multi_pv =
+      max_child_count < std::numeric_limits<std::size_t>::max();
+  if (is_multi_pv) {
+    agent.set_multi_pv(static_cast<int>(std::max<std::size_t>(
+        1, std::min<std::size_t>(max_child_count,
+                                 std::numeric_limits<int>::max()))));
+  }
+  Search_analysis analysis = agent.analyze(board, player_to_move);
+  std::vector<Child_statistics>& children =
+      is_multi_pv ? analysis.top_moves : analysis.children;
+  children.resize(std::min(children.size(), max_child_count));
+
+  std::ostringstream json;
+  json << "{\"id\": " << to_json_string(id) << ", \"move\": \""
+       << format_cell(analysis.best_move)
+       << "\", \"value\": " << analysis.best_move_value
+       << ", \"iterations\": " << analysis.statistics.iteration_count
+       << ", \"playouts_per_second\": "
+       << analysis.statistics.get_playouts_per_second() << ", \"elapsed_ms\": "
+       << std::chrono::duration<double, std::milli>(
+              analysis.statistics.total_time)
+              .count()
+       << ", \"children\": [";
+  for (std::size_t i = 0; i < children.size(); ++i) {
+    const Child_statistics& child = children[i];
+    json << (i ? ", " : "") << "{\"move\": \"" << format_cell(child.move)
+         << "\", \"visits\": " << child.visit_count
+         << ", \"wins\": " << child.win_count << ", \"value\": " << child.value
+         << ", \"score\": " << child.selection_score << "}";
+  }
+  json << "]}";
+  return json.str();
+}
+
+std::string make_analysis_error(const std::string& id,
+                                const std::string& message) {
+  return "{\"id\": " + to_json_string(id) +
+         ", \"error\": " + to_json_string(message) + "}";
+}
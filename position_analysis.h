@@ -0,0 +1,53 @@
+#ifndef POSITION_ANALYSIS_H
+#define POSITION_ANALYSIS_H
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include "board.h"
+#include "cell_state.h"
+
+/**
+ * @brief Searches a position with its own single-threaded and silent
+ * Mcts_agent and describes the result as a single-line JSON object:
+ *
+ *     {"id": "g1", "move": "f6", "value": 0.61, "iterations": 9135,
+ *      "playouts_per_second": 30421.5, "elapsed_ms": 300.2,
+ *      "children": [{"move": "f6", "visits": 1204, "wins": 734,
+ *                    "value": 0.61, "score": 0.68}, ...]}
+ *
+ * The object describes the Search_analysis of the agent. The value is the
+ * win ratio of the move for the player to move and the score that of the
+ * selection policy. All children are reported by decreasing visits, unless
+ * their number is limited: the search then keeps exploring that many moves
+ * in multi-PV mode, see Mcts_agent::set_multi_pv(), and reports them ranked
+ * by value. The function is thread-safe, so many positions can be analysed
+ * on separate threads at once.
+ *
+ * @param id The identifier of the position, written as the "id" member.
+ * @param board The position, which must not be won yet.
+ * @param player_to_move The player to move.
+ * @param search_time The time limit of the search.
+ * @param max_child_count The number of children to search as multi-PV and
+ * report, the best first. All of them by default, the most visited first.
+ * @return The JSON object, without a line break.
+ * @throws std::invalid_argument if the game is over.
+ */
+std::string analyze_position(
+    const std::string& id, const Board& board, Cell_state player_to_move,
+    std::chrono::milliseconds search_time,
+    std::size_t max_child_count = std::numeric_limits<std::size_t>::max());
+
+/**
+ * @brief Describes a position that could not be analysed as a single-line
+ * JSON object `{"id": "<id>", "error": "<message>"}`.
+ *
+ * @param id The identifier of the position.
+ * @param message The reason of the failure.
+ */
+std::string make_analysis_error(const std::string& id,
+                                const std::string& message);
+
+#endif  // POSITION_ANALYSIS_H
@@ -0,0 +1,147 @@
+#include "position_database.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+const char database_magic[4] = {'H', 'E', 'X', 'P'};
+const std::uint16_t database_format_version = 1;
+// Magic, version, board size and position count
+const std::size_t database_header_size = 16;
+
+}  // namespace
+
+std::size_t get_packed_position_size(int board_size) {
+  return 1 + (static_cast<std::size_t>(board_size) * board_size + 3) / 4;
+}
+
+void pack_position(const Board& board, Cell_state player_to_move,
+                   std::uint8_t* record) {
+  const int board_size = board.get_board_size();
+  std::fill(record, record + get_packed_position_size(board_size),
+            std::uint8_t(0));
+  record[0] = static_cast<std::uint8_t>(player_to_move);
+  int index = 0;
+  for (int row = 0; row < board_size; ++row) {
+    for (int col = 0; col < board_size; ++col, ++index) {
+      record[1 + index / 4] |= static_cast<std::uint8_t>(
+          static_cast<unsigned int>(board.get_cell(row, col))
+          << (2 * (index % 4)));
+    }
+  }
+}
+
+void Position_view::copy_to(Board& board) const {
+  if (board.get_board_size() != board_size) {
+    throw std::invalid_argument(
+        "The board size does not match the size of the position.");
+  }
+  board.assign_cells(*this);
+}
+
+Board Position_view::to_board() const {
+  Board board(board_size);
+  copy_to(board);
+  return board;
+}
+
+Position_database_writer::Position_database_writer(const std::string& path,
+                                                   int board_size)
+    : file(path, std::ios::binary | std::ios::trunc),
+      board_size(board_size),
+      record(get_packed_position_size(board_size)) {
+  if (!file) {
+    throw std::runtime_error("Cannot create " + path + ".");
+  }
+  const std::uint16_t size_field = static_cast<std::uint16_t>(board_size);
+  file.write(database_magic, sizeof(database_magic));
+  file.write(reinterpret_cast<const char*>(&database_format_version),
+             sizeof(database_format_version));
+  file.write(reinterpret_cast<const char*>(&size_field), sizeof(size_field));
+  file.write(reinterpret_cast<const char*>(&position_count),
+             sizeof(position_count));
+}
+
+Position_database_writer::~Position_database_writer() {
+  try {
+    close();
+  } catch (const std::runtime_error&) {
+    // Destructors must not throw; call close() to observe write errors.
+  }
+}
+
+void Position_database_writer::write(const Board& board,
+                                     Cell_state player_to_move) {
+  if (board.get_board_size() != board_size) {
+    throw std::invalid_argument(
+        "The board size does not match the size of the database.");
+  }
+  pack_position(board, player_to_move, record.data());
+  file.write(reinterpret_cast<const char*>(record.data()),
+             static_cast<std::streamsize>(record.size()));
+  ++position_count;
+}
+
+void Position_database_writer::close() {
+  if (!file.is_open()) return;
+  // Patch the position count into the header
+  file.seekp(8);
+  file.write(reinterpret_cast<const char*>(&position_count),
+             sizeof(position_count));
+  file.close();
+  if (!file) {
+    throw std::runtime_error("Cannot write the position database.");
+  }
+}
+
+Position_database::Position_database(const std::string& path) : file(path) {
+  const std::uint8_t* data = file.get_data();
+  if (file.get_size() < database_header_size ||
+      std::memcmp(data, database_magic, sizeof(database_magic)) != 0) {
+    throw std::runtime_error(path + " is not a position database.");
+  }
+  std::uint16_t version;
+  std::uint16_t size_field;
+  std::uint64_t count_field;
+  std::memcpy(&version, data + 4, sizeof(version));
+  std::memcpy(&size_field, data + 6, sizeof(size_field));
+  std::memcpy(&count_field, data + 8, sizeof(count_field));
+  if (version != database_format_version) {
+    throw std::runtime_error("Unsupported position database version.");
+  }
+  board_size = size_field;
+  position_count = static_cast<std::size_t>(count_field);
+  record_size = get_packed_position_size(board_size);
+  if (board_size < 2 ||
+      (file.get_size() - database_header_size) / record_size <
+          position_count) {
+    throw std::runtime_error(path + " is truncated or corrupted.");
+  }
+  records = data + database_header_size;
+}
+
+bool Position_database::is_database_file(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(database_magic)] = {};
+  file.read(magic, sizeof(magic));
+  return file && std::memcmp(magic, database_magic, sizeof(magic)) == 0;
+}
+
+int Position_database::get_board_size() const { return board_size; }
+
+std::size_t Position_database::size() const { return position_count; }
+
+Position_view Position_database::operator[](std::size_t index) const {
+  return Position_view(records + index * record_size, board_size);
+}
+
+Position_database::Iterator Position_database::begin() const {
+  return Iterator(records, record_size, board_size);
+}
+
+Position_database::Iterator Position_database::end() const {
+  return Iterator(records + position_count * record_size, record_size,
+                  board_size);
+}
@@ -0,0 +1,242 @@
+#ifndef POSITION_DATABASE_H
+#define POSITION_DATABASE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "board.h"
+#include "cell_state.h"
+#include "memory_mapped_file.h"
+
+/**
+ * @brief Returns the number of bytes of a packed position.
+ *
+ * A packed position is one byte holding the Cell_state of the player to move,
+ * followed by the cells in row-major order at 2 bits per cell (0 empty,
+ * 1 Blue, 2 Red), four cells per byte starting with the lowest bits. An 11x11
+ * position takes 32 bytes.
+ *
+ * @param board_size The size of the board.
+ */
+std::size_t get_packed_position_size(int board_size);
+
+/**
+ * @brief Packs a position into get_packed_position_size() bytes.
+ *
+ * @param board The board to pack.
+ * @param player_to_move The player to move, or Cell_state::Empty if unknown.
+ * @param record The destination of the packed position.
+ */
+void pack_position(const Board& board, Cell_state player_to_move,
+                   std::uint8_t* record);
+
+/**
+ * @class Position_view
+ *
+ * @brief A read-only view of a packed position that decodes cells on demand.
+ *
+ * The view only holds a pointer to the packed bytes, which usually live in a
+ * memory-mapped Position_database, so creating and iterating views never
+ * allocates. The view must not outlive the bytes it points to.
+ */
+class Position_view {
+ public:
+  /**
+   * @brief Constructs a view of a packed position.
+   *
+   * @param record The first byte of the packed position.
+   * @param board_size The size of the board.
+   */
+  Position_view(const std::uint8_t* record, int board_size)
+      : record(record), board_size(board_size) {}
+
+  /**
+   * @brief Getter for the size of the board.
+   */
+  int get_board_size() const { return board_size; }
+
+  /**
+   * @brief Getter for the player to move, Cell_state::Empty if unknown.
+   */
+  Cell_state get_player_to_move() const {
+    return static_cast<Cell_state>(record[0]);
+  }
+
+  /**
+   * @brief Decodes the state of a cell.
+   *
+   * @param move_x The x-coordinate (row) of the cell.
+   * @param move_y The y-coordinate (column) of the cell.
+   * @return The Cell_state of the cell.
+   */
+  Cell_state get_cell(int move_x, int move_y) const {
+    const int index = move_x * board_size + move_y;
+    return static_cast<Cell_state>(
+        (record[1 + index / 4] >> (2 * (index % 4))) & 3);
+  }
+
+  /**
+   * @brief Copies the position into an existing board of the same size,
+   * reusing its storage.
+   *
+   * @param board The board to overwrite.
+   * @throws std::invalid_argument if the board sizes differ.
+   */
+  void copy_to(Board& board) const;
+
+  /**
+   * @brief Creates a new board holding the position.
+   */
+  Board to_board() const;
+
+ private:
+  const std::uint8_t* record;
+  int board_size;
+};
+
+/**
+ * @class Position_database_writer
+ *
+ * @brief Streams packed positions of one board size into a database file.
+ *
+ * File layout: the magic "HEXP", the format version and the board size as
+ * 16-bit integers, the number of positions as a 64-bit integer, then the
+ * packed positions back to back. Integers use the byte order of the machine
+ * that wrote the file. The position count is written when the writer is
+ * closed or destroyed.
+ */
+class Position_database_writer {
+ public:
+  /**
+   * @brief Creates or replaces a database file.
+   *
+   * @param path The path of the file.
+   * @param board_size The size of the boards of every position.
+   * @throws std::runtime_error if the file cannot be created.
+   */
+  Position_database_writer(const std::string& path, int board_size);
+  ~Position_database_writer();
+
+  /**
+   * @brief Appends a position to the database.
+   *
+   * @param board The board of the position.
+   * @param player_to_move The player to move, or Cell_state::Empty if unknown.
+   * @throws std::invalid_argument if the board has the wrong size.
+   */
+  void write(const Board& board, Cell_state player_to_move);
+
+  /**
+   * @brief Completes the header and closes the file. Called by the
+   * destructor if it has not been called before.
+   *
+   * @throws std::runtime_error if the file cannot be written.
+   */
+  void close();
+
+ private:
+  std::ofstream file;
+  int board_size;
+  std::uint64_t position_count = 0;
+  std::vector<std::uint8_t> record;
+};
+
+/**
+ * @class Position_database
+ *
+ * @brief A memory-mapped, read-only file of packed positions.
+ *
+ * Positions are read in place from the mapping and exposed as Position_view
+ * objects, so a database of tens of millions of positions can be iterated
+ * without loading it or allocating per position:
+ *
+ *     Position_database database("positions.hexp");
+ *     for (Position_view position : database) { ... }
+ */
+class Position_database {
+ public:
+  /**
+   * @brief A forward iterator over the positions of the database.
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Position_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Position_view*;
+    using reference = Position_view;
+
+    Iterator(const std::uint8_t* record, std::size_t record_size,
+             int board_size)
+        : record(record), record_size(record_size), board_size(board_size) {}
+    Position_view operator*() const {
+      return Position_view(record, board_size);
+    }
+    Iterator& operator++() {
+      record += record_size;
+      return *this;
+    }
+    bool operator==(const Iterator& other) const {
+      return record == other.record;
+    }
+    bool operator!=(const Iterator& other) const {
+      return record != other.record;
+    }
+
+   private:
+    const std::uint8_t* record;
+    std::size_t record_size;
+    int board_size;
+  };
+
+  /**
+   * @brief Opens and maps a database file.
+   *
+   * @param path The path of the file.
+   * @throws std::runtime_error if the file cannot be mapped or is not a
+   * valid position database.
+   */
+  explicit Position_database(const std::string& path);
+
+  /**
+   * @brief Checks whether a file starts like a position database, e.g. to
+   * tell it apart from an SGF collection.
+   *
+   * @param path The path of the file.
+   * @return False if the file cannot be read or has another format.
+   */
+  static bool is_database_file(const std::string& path);
+
+  /**
+   * @brief Getter for the board size of every position.
+   */
+  int get_board_size() const;
+
+  /**
+   * @brief Returns the number of positions in the database.
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Returns a view of a position.
+   *
+   * @param index The index of the position, smaller than size().
+   */
+  Position_view operator[](std::size_t index) const;
+
+  Iterator begin() const;
+  Iterator end() const;
+
+ private:
+  Memory_mapped_file file;
+  int board_size;
+  std::size_t position_count;
+  std::size_t record_size;
+  const std::uint8_t* records;
+};
+
+#endif  // POSITION_DATABASE_H
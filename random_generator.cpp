@@ -0,0 +1,36 @@
+#include "random_generator.h"
+
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief Advances a splitmix64 state and returns the next output. Used only to
+ * expand seeds into the full xoshiro256** state.
+ */
+std::uint64_t splitmix64(std::uint64_t& splitmix_state) {
+  std::uint64_t result = (splitmix_state += 0x9E3779B97F4A7C15ULL);
+  result = (result ^ (result >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  result = (result ^ (result >> 27)) * 0x94D049BB133111EBULL;
+  return result ^ (result >> 31);
+}
+
+}  // namespace
+
+Random_generator::Random_generator(std::uint64_t seed) {
+  for (auto& word : state) {
+    word = splitmix64(seed);
+  }
+}
+
+Random_generator& Random_generator::for_current_thread() {
+  thread_local Random_generator generator([] {
+    std::random_device random_device;
+    std::uint64_t seed =
+        (static_cast<std::uint64_t>(random_device()) << 32) ^ random_device();
+    return seed ^ std::hash<std::thread::id>()(std::this_thread::get_id());
+  }());
+  return generator;
+}
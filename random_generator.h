@@ -0,0 +1,133 @@
+#ifndef RANDOM_GENERATOR_H
+#define RANDOM_GENERATOR_H
+
+#include <array>
+#include <cstdint>
+
+/**
+ * @class Random_generator
+ *
+ * @brief A small and fast pseudo-random number generator for the playouts of
+ * the Monte Carlo Tree Search (MCTS).
+ *
+ * The generator implements xoshiro256** by Blackman and Vigna, which keeps 32
+ * bytes of state (compared to the 2.5 KB of std::mt19937) and produces a 64-bit
+ * value with a handful of shifts, rotations and multiplications. Bounded
+ * integers are drawn with Lemire's multiply-shift method, which is free of
+ * modulo bias and needs a division only in the rare rejection case.
+ *
+ * The class satisfies the UniformRandomBitGenerator requirements, so it can
+ * also be passed to the standard library distributions if needed.
+ *
+ * @note The generator is not thread-safe. Each thread should use its own
+ * instance, which is what for_current_thread() provides.
+ */
+class Random_generator {
+ public:
+  using result_type = std::uint64_t;
+
+  /**
+   * @brief Constructs a new Random_generator.
+   *
+   * The 256-bit state is expanded from the 64-bit seed with splitmix64, as
+   * recommended by the authors of xoshiro, so that similar seeds still lead to
+   * uncorrelated streams.
+   *
+   * @param seed The seed of the generator.
+   */
+  explicit Random_generator(std::uint64_t seed);
+
+  /**
+   * @brief Returns the generator owned by the calling thread.
+   *
+   * The generator is created on the first call from a thread and is seeded
+   * from std::random_device mixed with the identifier of the thread, so that
+   * concurrent playouts draw independent sequences.
+   *
+   * @return A reference to the thread-local generator.
+   */
+  static Random_generator& for_current_thread();
+
+  /**
+   * @brief The smallest value that can be returned by operator().
+   */
+  static constexpr result_type min() { return 0; }
+
+  /**
+   * @brief The largest value that can be returned by operator().
+   */
+  static constexpr result_type max() { return UINT64_MAX; }
+
+  /**
+   * @brief Advances the generator and returns the next 64-bit value.
+   *
+   * @return A uniformly distributed 64-bit value.
+   */
+  result_type operator()() {
+    const std::uint64_t result = rotate_left(state[1] * 5, 7) * 9;
+    const std::uint64_t shifted = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= shifted;
+    state[3] = rotate_left(state[3], 45);
+    return result;
+  }
+
+  /**
+   * @brief Draws a uniformly distributed integer from [0, range).
+   *
+   * Uses Lemire's nearly divisionless method: the upper 32 bits of a 32-bit
+   * random value multiplied by the range are taken as the result, and the
+   * rare values that would introduce a bias are rejected.
+   *
+   * @param range The exclusive upper bound. Must be greater than 0.
+   * @return A uniformly distributed integer in [0, range).
+   */
+  std::uint32_t next_bounded(std::uint32_t range) {
+    std::uint64_t product =
+        static_cast<std::uint64_t>(next_32_bits()) * range;
+    std::uint32_t low_bits = static_cast<std::uint32_t>(product);
+    if (low_bits < range) {
+      const std::uint32_t threshold = (0u - range) % range;
+      while (low_bits < threshold) {
+        product = static_cast<std::uint64_t>(next_32_bits()) * range;
+        low_bits = static_cast<std::uint32_t>(product);
+      }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+  }
+
+  /**
+   * @brief Draws a uniformly distributed real number from [0, 1).
+   *
+   * @return The upper 53 bits of the next value scaled to [0, 1).
+   */
+  double next_double() {
+    return static_cast<double>((*this)() >> 11) * (1. / 9007199254740992.);
+  }
+
+ private:
+  /**
+   * @brief The 256-bit state of the xoshiro256** generator.
+   */
+  std::array<std::uint64_t, 4> state;
+
+  /**
+   * @brief Returns the upper 32 bits of the next 64-bit value, which are the
+   * bits of the best quality.
+   */
+  std::uint32_t next_32_bits() {
+    return static_cast<std::uint32_t>((*this)() >> 32);
+  }
+
+  /**
+   * @brief Rotates a 64-bit value to the left by the given number of bits.
+   */
+  static std::uint64_t rotate_left(std::uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
+};
+
+#endif  // RANDOM_GENERATOR_H
@@ -0,0 +1,62 @@
+#ifndef SEARCH_OPTIONS_H
+#define SEARCH_OPTIONS_H
+
+#include <stdexcept>
+
+#include "selection_policy.h"
+
+/**
+ * @struct Search_options
+ *
+ * @brief The tuning options of the searches of an Mcts_agent, applied
+ * together with Mcts_agent::set_search_options().
+ *
+ * The defaults give plain UCT: complete playouts, no prior knowledge, no
+ * widening, UCB1, the highest win ratio as the final move and no search
+ * extension. The individual setters of Mcts_agent document each option.
+ */
+struct Search_options {
+  /// Random moves per playout before it is scored statically, 0 for none.
+  int playout_cutoff_depth = 0;
+  int prior_visit_count = 0;  ///< Virtual playouts of each child.
+  double progressive_bias_weight = 0.;  ///< Weight of the progressive bias.
+  double widening_constant = 0.;  ///< Initial selectable children, 0 for all.
+  double widening_exponent = 0.;  ///< Growth rate of the selectable children.
+  /// The policy scoring the children in selection.
+  Selection_policy_type selection_policy = Selection_policy_type::Ucb1;
+  /// How the move is chosen when the search ends.
+  Final_move_criterion final_move_criterion = Final_move_criterion::Max_value;
+  /// The longest search extension as a multiple of the decision time.
+  double search_extension_ratio = 0.;
+  int multi_pv_count = 1;  ///< Moves of the root kept explored, 1 for none.
+
+  /**
+   * @brief Checks that every option is within its range.
+   *
+   * @throws std::invalid_argument naming the first option out of range.
+   */
+  void validate() const {
+    if (playout_cutoff_depth < 0) {
+      throw std::invalid_argument(
+          "The playout cutoff depth cannot be negative.");
+    }
+    if (prior_visit_count < 0 || progressive_bias_weight < 0.) {
+      throw std::invalid_argument(
+          "The prior knowledge parameters cannot be negative.");
+    }
+    if (widening_constant < 0. || widening_exponent < 0.) {
+      throw std::invalid_argument(
+          "The progressive widening parameters cannot be negative.");
+    }
+    if (search_extension_ratio < 0.) {
+      throw std::invalid_argument(
+          "The search extension ratio cannot be negative.");
+    }
+    if (multi_pv_count < 1) {
+      throw std::invalid_argument(
+          "The multi-PV move count must be at least 1.");
+    }
+  }
+};
+
+#endif  // SEARCH_OPTIONS_H
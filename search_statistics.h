@@ -0,0 +1,109 @@
+#ifndef SEARCH_STATISTICS_H
+#define SEARCH_STATISTICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct Child_statistics
+ *
+ * @brief The statistics of one child of the root after a search, i.e. of one
+ * candidate move.
+ */
+struct Child_statistics {
+  std::pair<int, int> move;  ///< The move leading to the child.
+  int win_count;             ///< Playouts through the child won by the mover.
+  int visit_count;           ///< Playouts through the child.
+  /// The win ratio including the virtual playouts of the prior, as compared
+  /// by the final move criteria, or 0 without any visit.
+  double value = 0.;
+  /// The score of the agent's selection policy at the end of the search, the
+  /// UCT score under UCB1.
+  double selection_score = 0.;
+
+  /**
+   * @brief Returns the win ratio of the move, 0 if it was never visited.
+   */
+  double get_win_ratio() const {
+    return visit_count > 0 ? static_cast<double>(win_count) / visit_count : 0.;
+  }
+};
+
+/**
+ * @struct Search_statistics
+ *
+ * @brief Counters and timers collected by Mcts_agent during one search.
+ *
+ * The agent fills in a Search_statistics on every call to choose_move. The
+ * phases are timed with one clock read at each phase boundary, which is cheap
+ * compared to a playout, so the statistics are always collected. They are
+ * printed through the Logger in verbose mode and can be read from the agent
+ * with get_last_search_statistics().
+ */
+struct Search_statistics {
+  using Duration = std::chrono::nanoseconds;
+
+  int iteration_count = 0;         ///< MCTS iterations completed.
+  long long playout_count = 0;     ///< Random playouts simulated.
+  long long nodes_allocated = 0;   ///< Tree nodes created, including the root.
+  int max_tree_depth = 0;          ///< Deepest node selected for a playout.
+  int pruned_move_count = 0;       ///< Moves pruned as inferior cells.
+  int search_extension_count = 0;  ///< Slices searched past the deadline.
+  Duration selection_time{0};      ///< Time spent selecting children.
+  Duration expansion_time{0};      ///< Time spent expanding nodes.
+  Duration simulation_time{0};     ///< Wall time spent in playouts.
+  Duration backpropagation_time{0};  ///< Time spent backpropagating results.
+  Duration total_time{0};          ///< Wall time of the whole search.
+  /// Time each playout thread spent simulating, indexed by thread.
+  std::vector<Duration> thread_busy_times;
+
+  /**
+   * @brief Returns the number of playouts simulated per second of search.
+   */
+  double get_playouts_per_second() const {
+    return total_time.count() > 0
+               ? playout_count * 1e9 / static_cast<double>(total_time.count())
+               : 0.;
+  }
+
+  /**
+   * @brief Returns the fraction of the simulation wall time that a playout
+   * thread spent simulating, between 0 and 1.
+   *
+   * @param thread_index The index of the playout thread.
+   */
+  double get_thread_utilisation(std::size_t thread_index) const {
+    return simulation_time.count() > 0
+               ? thread_busy_times[thread_index].count() /
+                     static_cast<double>(simulation_time.count())
+               : 0.;
+  }
+};
+
+/**
+ * @struct Search_analysis
+ *
+ * @brief The outcome of one search: the chosen move and the statistics of
+ * every candidate, so that tools can inspect a search without verbose
+ * logging.
+ *
+ * Mcts_agent only expands the root and plays out from its children, so the
+ * search has no line of play beyond the first move: the analysis covers the
+ * candidate moves, without a principal variation.
+ */
+struct Search_analysis {
+  std::pair<int, int> best_move{-1, -1};  ///< The move chosen by the search.
+  double best_move_value = 0.;  ///< The value of the chosen move.
+  /// The children of the root, most visited first.
+  std::vector<Child_statistics> children;
+  /// The visited children with the highest values, best first: as many as
+  /// the multi-PV mode of the agent keeps exploring, one by default.
+  std::vector<Child_statistics> top_moves;
+  /// The counters and timers of the search, e.g. the iterations, the
+  /// playouts per second and the elapsed time.
+  Search_statistics statistics;
+};
+
+#endif  // SEARCH_STATISTICS_H
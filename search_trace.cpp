@@ -0,0 +1,140 @@
+#include "search_trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const char trace_magic[8] = {'H', 'E', 'X', 'T', 'R', 'A', 'C', 'E'};
+const std::uint32_t trace_format_version = 1;
+// The events read at once when loading a trace
+const std::uint64_t load_chunk_event_count = 1 << 16;
+
+template <typename T>
+void write_value(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_value(std::istream& is) {
+  T value;
+  if (!is.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+    throw std::runtime_error("Unexpected end of the search trace.");
+  }
+  return value;
+}
+
+}  // namespace
+
+const char* to_string(Trace_event_type type) {
+  switch (type) {
+    case Trace_event_type::Search_start:
+      return "search_start";
+    case Trace_event_type::Iteration_start:
+      return "iteration_start";
+    case Trace_event_type::Selection:
+      return "selection";
+    case Trace_event_type::Playout_start:
+      return "playout_start";
+    case Trace_event_type::Playout_move:
+      return "playout_move";
+    case Trace_event_type::Playout_end:
+      return "playout_end";
+    case Trace_event_type::Backpropagation:
+      return "backpropagation";
+    case Trace_event_type::Search_end:
+      return "search_end";
+  }
+  return "unknown";
+}
+
+Search_trace::Search_trace(std::size_t events_per_thread)
+    : events_per_thread(events_per_thread),
+      creation_time(std::chrono::steady_clock::now()) {
+  if (events_per_thread == 0) {
+    throw std::invalid_argument(
+        "A search trace needs room for at least one event per thread.");
+  }
+}
+
+void Search_trace::prepare_threads(unsigned int number_of_threads) {
+  while (buffers.size() < number_of_threads) {
+    buffers.emplace_back();
+    buffers.back().events.resize(events_per_thread);
+  }
+}
+
+void Search_trace::save(std::ostream& os) const {
+  os.write(trace_magic, sizeof(trace_magic));
+  write_value(os, trace_format_version);
+  write_value(os, static_cast<std::uint32_t>(sizeof(Trace_event)));
+  write_value(os, static_cast<std::uint32_t>(buffers.size()));
+  for (const auto& buffer : buffers) {
+    const std::uint64_t capacity = buffer.events.size();
+    const std::uint64_t stored_count =
+        std::min<std::uint64_t>(buffer.written_count, capacity);
+    write_value(os, stored_count);
+    write_value(os, buffer.written_count - stored_count);
+    // The oldest stored event sits right after the newest one once the ring
+    // has wrapped around.
+    const std::uint64_t oldest_index =
+        buffer.written_count > capacity ? buffer.written_count % capacity : 0;
+    for (std::uint64_t i = 0; i < stored_count; ++i) {
+      write_value(os, buffer.events[(oldest_index + i) % capacity]);
+    }
+  }
+}
+
+void Search_trace::save_to_file(const std::string& path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw std::runtime_error("Cannot open search trace file " + path + ".");
+  }
+  save(file);
+  if (!file) {
+    throw std::runtime_error("Cannot write search trace file " + path + ".");
+  }
+}
+
+std::vector<Search_trace::Thread_events> Search_trace::load(std::istream& is) {
+  char magic[sizeof(trace_magic)];
+  if (!is.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, trace_magic, sizeof(magic)) != 0) {
+    throw std::runtime_error("The input is not a search trace.");
+  }
+  if (read_value<std::uint32_t>(is) != trace_format_version) {
+    throw std::runtime_error("Unsupported search trace version.");
+  }
+  if (read_value<std::uint32_t>(is) != sizeof(Trace_event)) {
+    throw std::runtime_error("Search trace event size mismatch.");
+  }
+  // The counts come from the file, so memory grows only with the data that
+  // is actually read: a truncated or corrupt trace fails on the missing bytes
+  // instead of allocating what its counts claim
+  const auto thread_count = read_value<std::uint32_t>(is);
+  std::vector<Thread_events> threads;
+  for (std::uint32_t thread_index = 0; thread_index < thread_count;
+       ++thread_index) {
+    Thread_events thread;
+    const auto stored_count = read_value<std::uint64_t>(is);
+    thread.dropped_count = read_value<std::uint64_t>(is);
+    for (std::uint64_t read_count = 0; read_count < stored_count;) {
+      const std::size_t chunk_count = static_cast<std::size_t>(
+          std::min<std::uint64_t>(stored_count - read_count,
+                                  load_chunk_event_count));
+      const std::size_t old_size = thread.events.size();
+      thread.events.resize(old_size + chunk_count);
+      if (!is.read(reinterpret_cast<char*>(thread.events.data() + old_size),
+                   static_cast<std::streamsize>(chunk_count *
+                                                sizeof(Trace_event)))) {
+        throw std::runtime_error("Unexpected end of the search trace.");
+      }
+      read_count += chunk_count;
+    }
+    threads.push_back(std::move(thread));
+  }
+  return threads;
+}
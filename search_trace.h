@@ -0,0 +1,197 @@
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cell_state.h"
+
+/**
+ * @enum Trace_event_type
+ * @brief The kind of a Trace_event recorded during a search.
+ */
+enum class Trace_event_type : std::uint8_t {
+  Search_start,     ///< A call to choose_move started.
+  Iteration_start,  ///< An MCTS iteration started.
+  Selection,        ///< A child was selected for playout.
+  Playout_start,    ///< A random playout started from a node.
+  Playout_move,     ///< A random move was made in a playout.
+  Playout_end,      ///< A playout detected a winner.
+  Backpropagation,  ///< A node was updated with a playout result.
+  Search_end        ///< A call to choose_move chose its move.
+};
+
+/**
+ * @brief Returns the name of a trace event type, e.g. "selection".
+ */
+const char* to_string(Trace_event_type type);
+
+/**
+ * @struct Trace_event
+ * @brief A fixed-size binary record of one step of a search.
+ *
+ * The meaning of the generic fields depends on the type:
+ * - Search_start: player to move, wins = board size, visits = thread count.
+ * - Iteration_start: iteration.
+ * - Selection: move of the selected child, score = its UCT score (infinity
+ *   for unvisited children).
+ * - Playout_start / Playout_move: player and move.
+ * - Playout_end: player = winner.
+ * - Backpropagation: move of the node, its wins and visits after the update.
+ * - Search_end: chosen move, iteration = iterations completed.
+ *
+ * The struct is written to trace files verbatim, in the byte order of the
+ * machine that recorded it.
+ */
+struct Trace_event {
+  std::uint64_t timestamp_ns;  ///< Nanoseconds since the trace was created.
+  std::int32_t iteration;      ///< MCTS iteration the event belongs to.
+  std::int32_t wins;           ///< Type-dependent counter (see above).
+  std::int32_t visits;         ///< Type-dependent counter (see above).
+  float score;                 ///< Type-dependent score (see above).
+  std::int16_t move_x;         ///< Row of the move, -1 if not applicable.
+  std::int16_t move_y;         ///< Column of the move, -1 if not applicable.
+  std::uint16_t thread_index;  ///< Index of the recording thread.
+  Trace_event_type type;       ///< The kind of the event.
+  std::uint8_t player;         ///< Cell_state of the event, Empty if none.
+};
+
+static_assert(sizeof(Trace_event) == 32,
+              "Trace files rely on a 32-byte Trace_event.");
+
+/**
+ * @class Search_trace
+ *
+ * @brief Records structured, binary events of Mcts_agent searches into
+ * per-thread ring buffers.
+ *
+ * Unlike the verbose Logger, recording an event is a plain store into a
+ * preallocated buffer owned by the recording thread, without formatting,
+ * locking or I/O, so tracing can stay enabled at production speed and in
+ * parallel mode. When a buffer is full, the oldest events are overwritten and
+ * counted as dropped. The trace is written to a compact binary file with
+ * save_to_file() and rendered offline with the trace_dump tool.
+ *
+ * File layout: the magic "HEXTRACE", then the format version, the event size
+ * and the number of threads as 32-bit integers, then for each thread the
+ * number of stored and dropped events as 64-bit integers followed by the
+ * stored events from oldest to newest.
+ *
+ * @note Each thread index must be recorded from one thread at a time. The
+ * trace must not be saved while a search is running.
+ */
+class Search_trace {
+ public:
+  /**
+   * @brief The events of one thread, as read back from a trace file.
+   */
+  struct Thread_events {
+    std::vector<Trace_event> events;  ///< Stored events, oldest first.
+    std::uint64_t dropped_count;      ///< Events overwritten in the ring.
+  };
+
+  /**
+   * @brief Constructs a new Search_trace.
+   *
+   * @param events_per_thread The capacity of each thread's ring buffer.
+   *
+   * @throws std::invalid_argument if events_per_thread is 0.
+   */
+  explicit Search_trace(std::size_t events_per_thread = 1 << 16);
+
+  /**
+   * @brief Makes sure that a ring buffer exists for every thread index used
+   * by the next search. Must be called before the search starts its threads.
+   *
+   * @param number_of_threads The number of threads of the next search.
+   */
+  void prepare_threads(unsigned int number_of_threads);
+
+  /**
+   * @brief Records an event into the ring buffer of a thread.
+   *
+   * Events of unknown thread indices are ignored.
+   *
+   * @param thread_index The index of the recording thread.
+   * @param type The kind of the event.
+   * @param player The player of the event.
+   * @param move The move of the event, (-1, -1) if not applicable.
+   * @param iteration The MCTS iteration of the event.
+   * @param wins The first type-dependent counter.
+   * @param visits The second type-dependent counter.
+   * @param score The type-dependent score.
+   */
+  void record(unsigned int thread_index, Trace_event_type type,
+              Cell_state player, const std::pair<int, int>& move,
+              int iteration, int wins = 0, int visits = 0,
+              double score = 0.) {
+    if (thread_index >= buffers.size()) return;
+    Ring_buffer& buffer = buffers[thread_index];
+    Trace_event& event =
+        buffer.events[buffer.written_count % buffer.events.size()];
+    event.timestamp_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - creation_time)
+            .count());
+    event.iteration = iteration;
+    event.wins = wins;
+    event.visits = visits;
+    // Scores beyond the float range (the "infinite" UCT of unvisited nodes)
+    // are stored as infinity.
+    event.score = score < std::numeric_limits<float>::max()
+                      ? static_cast<float>(score)
+                      : std::numeric_limits<float>::infinity();
+    event.move_x = static_cast<std::int16_t>(move.first);
+    event.move_y = static_cast<std::int16_t>(move.second);
+    event.thread_index = static_cast<std::uint16_t>(thread_index);
+    event.type = type;
+    event.player = static_cast<std::uint8_t>(player);
+    ++buffer.written_count;
+  }
+
+  /**
+   * @brief Writes the recorded events to a binary stream.
+   *
+   * @param os The stream to write to. It should be opened in binary mode.
+   */
+  void save(std::ostream& os) const;
+
+  /**
+   * @brief Writes the recorded events to a binary file, replacing it.
+   *
+   * @param path The path of the file.
+   * @throws std::runtime_error if the file cannot be written.
+   */
+  void save_to_file(const std::string& path) const;
+
+  /**
+   * @brief Reads the events of every thread from a binary trace stream.
+   *
+   * @param is The stream to read from. It should be opened in binary mode.
+   * @return The events of each thread, indexed by thread index.
+   * @throws std::runtime_error if the stream is not a valid trace.
+   */
+  static std::vector<Thread_events> load(std::istream& is);
+
+ private:
+  /**
+   * @brief A ring buffer of the events of one thread.
+   */
+  struct Ring_buffer {
+    std::vector<Trace_event> events;  ///< Preallocated storage.
+    std::uint64_t written_count = 0;  ///< Events ever recorded.
+  };
+
+  std::size_t events_per_thread;
+  std::chrono::steady_clock::time_point creation_time;
+  std::vector<Ring_buffer> buffers;
+};
+
+#endif  // SEARCH_TRACE_H
@@ -0,0 +1,118 @@
+#ifndef SELECTION_POLICY_H
+#define SELECTION_POLICY_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "random_generator.h"
+
+/**
+ * @brief The selection policies available to Mcts_agent.
+ */
+enum class Selection_policy_type {
+  Ucb1,        ///< UCB1, the classic UCT formula.
+  Ucb1_tuned,  ///< UCB1-Tuned, scaling exploration by the observed variance.
+  Puct,        ///< PUCT, exploring in proportion to the prior values.
+  Thompson     ///< Thompson sampling from the Beta posterior of each child.
+};
+
+/**
+ * @brief The criteria by which Mcts_agent chooses its move among the children
+ * of the root when the search ends.
+ */
+enum class Final_move_criterion {
+  Max_value,    ///< The child with the highest win ratio.
+  Most_visits,  ///< The most visited child.
+  Robust_max,   ///< A child with both, else the most visits and wins together.
+  Secure_child  ///< The child with the highest lower confidence bound.
+};
+
+/**
+ * @struct Selection_context
+ *
+ * @brief The values that every child of a node shares during one selection.
+ */
+struct Selection_context {
+  double exploration_factor;  ///< The exploration constant of the agent.
+  double parent_visit_count;  ///< Visits of the parent, virtual ones included.
+  double log_parent_visit_count;  ///< Natural logarithm of the above.
+  double prior_sum;  ///< Sum of the prior values of the selectable children.
+  Random_generator* random_generator;  ///< Generator for sampling policies.
+};
+
+/**
+ * @brief The selection policies score a child from its statistics, i.e. its
+ * wins and visits (both including virtual playouts of the prior) and its prior
+ * value. The child with the highest score is selected.
+ *
+ * Each policy is a struct with a static score() function, and Mcts_agent
+ * instantiates its selection loop once per policy, so the choice of policy
+ * costs one branch per selection and the score is inlined into the loop.
+ */
+struct Ucb1_policy {
+  static double score(double wins, double visits, double /*prior_value*/,
+                      const Selection_context& context) {
+    if (visits == 0) return std::numeric_limits<double>::max();
+    return wins / visits +
+           context.exploration_factor *
+               std::sqrt(context.log_parent_visit_count / visits);
+  }
+};
+
+/**
+ * @brief UCB1-Tuned bounds the exploration of a child by the variance of its
+ * results, here the Bernoulli variance of its win ratio plus a confidence
+ * term. The exploration factor is relative to sqrt(2), at which the formula
+ * is the original one.
+ */
+struct Ucb1_tuned_policy {
+  static double score(double wins, double visits, double /*prior_value*/,
+                      const Selection_context& context) {
+    if (visits == 0) return std::numeric_limits<double>::max();
+    const double win_ratio = wins / visits;
+    const double variance_bound =
+        win_ratio - win_ratio * win_ratio +
+        std::sqrt(2. * context.log_parent_visit_count / visits);
+    return win_ratio +
+           context.exploration_factor / std::sqrt(2.) *
+               std::sqrt(context.log_parent_visit_count / visits *
+                         std::min(0.25, variance_bound));
+  }
+};
+
+/**
+ * @brief PUCT explores children in proportion to their share of the prior
+ * values, decaying with their visits. An unvisited child is valued at its
+ * prior value.
+ */
+struct Puct_policy {
+  static double score(double wins, double visits, double prior_value,
+                      const Selection_context& context) {
+    const double value = visits > 0 ? wins / visits : prior_value;
+    const double prior_share =
+        context.prior_sum > 0 ? prior_value / context.prior_sum : 0.;
+    return value + context.exploration_factor * prior_share *
+                       std::sqrt(context.parent_visit_count) / (1. + visits);
+  }
+};
+
+/**
+ * @brief Thompson sampling draws a win probability from the Beta(wins + 1,
+ * losses + 1) posterior of each child, so children are selected with the
+ * probability that they are the best. The exploration factor is not used.
+ */
+struct Thompson_policy {
+  static double score(double wins, double visits, double /*prior_value*/,
+                      const Selection_context& context) {
+    // A Beta variate is the first of two Gamma variates over their sum
+    std::gamma_distribution<double> win_distribution(wins + 1.);
+    std::gamma_distribution<double> loss_distribution(visits - wins + 1.);
+    const double win_sample = win_distribution(*context.random_generator);
+    const double loss_sample = loss_distribution(*context.random_generator);
+    return win_sample / (win_sample + loss_sample);
+  }
+};
+
+#endif  // SELECTION_POLICY_H
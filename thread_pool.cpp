@@ -0,0 +1,84 @@
+#include "thread_pool.h"
+
+#include <stdexcept>
+
+Thread_pool::Thread_pool(unsigned int thread_count)
+    : thread_count(thread_count) {
+  if (thread_count == 0) {
+    throw std::invalid_argument("A thread pool needs at least one thread.");
+  }
+  // The calling thread runs the tasks as thread 0
+  for (unsigned int thread_index = 1; thread_index < thread_count;
+       ++thread_index) {
+    threads.emplace_back(&Thread_pool::work, this, thread_index);
+  }
+}
+
+Thread_pool::~Thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    is_stopping = true;
+  }
+  task_available.notify_all();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+unsigned int Thread_pool::get_thread_count() const { return thread_count; }
+
+void Thread_pool::run(const std::function<void(unsigned int)>& task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    current_task = &task;
+    pending_thread_count = thread_count - 1;
+    task_exception = nullptr;
+    ++task_generation;
+  }
+  task_available.notify_all();
+  std::exception_ptr calling_thread_exception;
+  try {
+    task(0);
+  } catch (...) {
+    calling_thread_exception = std::current_exception();
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  task_finished.wait(lock, [this] { return pending_thread_count == 0; });
+  current_task = nullptr;
+  if (calling_thread_exception) {
+    std::rethrow_exception(calling_thread_exception);
+  }
+  if (task_exception) {
+    std::rethrow_exception(task_exception);
+  }
+}
+
+void Thread_pool::work(unsigned int thread_index) {
+  unsigned long long last_generation = 0;
+  while (true) {
+    const std::function<void(unsigned int)>* task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      task_available.wait(lock, [&] {
+        return is_stopping || task_generation != last_generation;
+      });
+      if (is_stopping) return;
+      last_generation = task_generation;
+      task = current_task;
+    }
+    std::exception_ptr exception;
+    try {
+      (*task)(thread_index);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (exception && !task_exception) {
+        task_exception = exception;
+      }
+      --pending_thread_count;
+    }
+    task_finished.notify_one();
+  }
+}
@@ -0,0 +1,79 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Thread_pool
+ *
+ * @brief A fixed set of threads that run one task on every thread at a time
+ * and wait for all of them to finish, as the leaf parallelization of
+ * Mcts_agent does on every iteration.
+ *
+ * The threads are started once and sleep on a condition variable between
+ * tasks, so a task costs two notifications instead of creating and joining a
+ * thread per playout. The calling thread takes part as thread 0, so a pool of
+ * n threads starts n - 1 of its own.
+ */
+class Thread_pool {
+ public:
+  /**
+   * @brief Starts the threads of the pool.
+   *
+   * @param thread_count The number of threads running each task, including
+   * the calling thread. At least 1.
+   * @throws std::invalid_argument if thread_count is 0.
+   */
+  explicit Thread_pool(unsigned int thread_count);
+
+  /**
+   * @brief Stops and joins the threads of the pool.
+   */
+  ~Thread_pool();
+
+  Thread_pool(const Thread_pool&) = delete;
+  Thread_pool& operator=(const Thread_pool&) = delete;
+
+  /**
+   * @brief Getter for the number of threads running each task.
+   */
+  unsigned int get_thread_count() const;
+
+  /**
+   * @brief Runs a task once on every thread of the pool and returns when all
+   * of them have finished.
+   *
+   * @param task The task, called with the index of the thread running it,
+   * from 0 to get_thread_count() - 1.
+   * @throws The first exception thrown by the task on any thread, after all
+   * threads have finished.
+   */
+  void run(const std::function<void(unsigned int)>& task);
+
+ private:
+  unsigned int thread_count;
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable task_available;
+  std::condition_variable task_finished;
+  // The task being run, valid while pending_thread_count is positive
+  const std::function<void(unsigned int)>* current_task = nullptr;
+  // Incremented for every task, so that each thread runs a task only once
+  unsigned long long task_generation = 0;
+  unsigned int pending_thread_count = 0;
+  std::exception_ptr task_exception;
+  bool is_stopping = false;
+
+  /**
+   * @brief The loop of a pool thread, running each new task until the pool
+   * stops.
+   */
+  void work(unsigned int thread_index);
+};
+
+#endif  // THREAD_POOL_H
@@ -0,0 +1,134 @@
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "search_trace.h"
+
+/**
+ * @brief Converts the raw player of a Trace_event back to a Cell_state.
+ */
+Cell_state player_of(const Trace_event& event) {
+  return static_cast<Cell_state>(event.player);
+}
+
+/**
+ * @brief Writes a human-readable line for every event of the trace.
+ *
+ * @param os The output stream.
+ * @param threads The events of each thread.
+ */
+void write_text(std::ostream& os,
+                const std::vector<Search_trace::Thread_events>& threads) {
+  for (std::size_t thread_index = 0; thread_index < threads.size();
+       ++thread_index) {
+    const auto& thread = threads[thread_index];
+    os << "THREAD " << thread_index << ": " << thread.events.size()
+       << " events, " << thread.dropped_count << " dropped\n";
+    for (const auto& event : thread.events) {
+      os << "[" << event.timestamp_ns / 1000 << " us] iteration "
+         << event.iteration << " " << to_string(event.type);
+      switch (event.type) {
+        case Trace_event_type::Search_start:
+          os << ": " << player_of(event) << " to move on a " << event.wins
+             << "x" << event.wins << " board with " << event.visits
+             << " thread(s)";
+          break;
+        case Trace_event_type::Selection:
+          os << ": " << event.move_x << ", " << event.move_y << " with UCT ";
+          if (std::isinf(event.score)) {
+            os << "infinity";
+          } else {
+            os << event.score;
+          }
+          break;
+        case Trace_event_type::Playout_start:
+        case Trace_event_type::Playout_move:
+          os << ": " << player_of(event) << " at " << event.move_x << ", "
+             << event.move_y;
+          break;
+        case Trace_event_type::Playout_end:
+          os << ": " << player_of(event) << " wins";
+          break;
+        case Trace_event_type::Backpropagation:
+          os << ": " << event.move_x << ", " << event.move_y << " has "
+             << event.wins << " wins and " << event.visits << " visits";
+          break;
+        case Trace_event_type::Search_end:
+          os << ": chose " << event.move_x << ", " << event.move_y;
+          break;
+        case Trace_event_type::Iteration_start:
+          break;
+      }
+      os << "\n";
+    }
+  }
+}
+
+/**
+ * @brief Writes the trace as a JSON document with one array of events per
+ * thread.
+ *
+ * @param os The output stream.
+ * @param threads The events of each thread.
+ */
+void write_json(std::ostream& os,
+                const std::vector<Search_trace::Thread_events>& threads) {
+  os << "{\"threads\": [";
+  for (std::size_t thread_index = 0; thread_index < threads.size();
+       ++thread_index) {
+    const auto& thread = threads[thread_index];
+    os << (thread_index ? ",\n" : "\n") << "{\"thread\": " << thread_index
+       << ", \"dropped\": " << thread.dropped_count << ", \"events\": [";
+    for (std::size_t i = 0; i < thread.events.size(); ++i) {
+      const auto& event = thread.events[i];
+      os << (i ? ",\n" : "\n") << "{\"t_ns\": " << event.timestamp_ns
+         << ", \"type\": \"" << to_string(event.type)
+         << "\", \"iteration\": " << event.iteration << ", \"player\": \""
+         << player_of(event) << "\", \"move\": [" << event.move_x << ", "
+         << event.move_y << "], \"wins\": " << event.wins
+         << ", \"visits\": " << event.visits << ", \"score\": ";
+      // JSON has no infinity, so unbounded scores are written as null
+      if (std::isfinite(event.score)) {
+        os << event.score << "}";
+      } else {
+        os << "null}";
+      }
+    }
+    os << "]}";
+  }
+  os << "\n]}\n";
+}
+
+/**
+ * @brief Renders a binary search trace recorded by Mcts_agent as text or JSON.
+ *
+ * Usage: trace_dump <trace file> [--json]
+ */
+int main(int argc, char* argv[]) {
+  if (argc < 2 || argc > 3 || (argc == 3 && std::strcmp(argv[2], "--json"))) {
+    std::cerr << "Usage: " << argv[0] << " <trace file> [--json]\n";
+    return 1;
+  }
+  std::ifstream file(argv[1], std::ios::binary);
+  if (!file) {
+    std::cerr << "Error: cannot open " << argv[1] << "\n";
+    return 1;
+  }
+  try {
+    std::vector<Search_trace::Thread_events> threads =
+        Search_trace::load(file);
+    if (argc == 3) {
+      write_json(std::cout, threads);
+    } else {
+      write_text(std::cout, threads);
+    }
+  } catch (const std::runtime_error& e) {
+    std::cerr << "Error: " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
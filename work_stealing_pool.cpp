@@ -0,0 +1,111 @@
+#include "work_stealing_pool.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// The pool and worker index of the calling thread, if it is a worker
+thread_local const Work_stealing_pool* current_pool = nullptr;
+thread_local unsigned int current_worker_index = 0;
+
+}  // namespace
+
+Work_stealing_pool::Work_stealing_pool(unsigned int thread_count) {
+  if (thread_count == 0) {
+    throw std::invalid_argument("A thread pool needs at least one thread.");
+  }
+  for (unsigned int worker_index = 0; worker_index < thread_count;
+       ++worker_index) {
+    queues.push_back(std::make_unique<Task_queue>());
+  }
+  for (unsigned int worker_index = 0; worker_index < thread_count;
+       ++worker_index) {
+    workers.emplace_back(&Work_stealing_pool::work, this, worker_index);
+  }
+}
+
+Work_stealing_pool::~Work_stealing_pool() {
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex);
+    is_stopping = true;
+  }
+  task_queued.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+unsigned int Work_stealing_pool::get_thread_count() const {
+  return static_cast<unsigned int>(workers.size());
+}
+
+void Work_stealing_pool::submit(std::function<void()> task) {
+  Task_queue& queue = current_pool == this ? *queues[current_worker_index]
+                                            : injection_queue;
+  {
+    std::lock_guard<std::mutex> queue_lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+    // The count changes together with the queues, always locking a queue
+    // before wake_mutex, so it is never ahead of or behind the tasks
+    std::lock_guard<std::mutex> lock(wake_mutex);
+    ++queued_task_count;
+  }
+  task_queued.notify_one();
+}
+
+bool Work_stealing_pool::take_task(unsigned int worker_index,
+                                   std::function<void()>& task) {
+  // The own queue is used as a stack, the others are robbed from the front
+  if (take_task_from(*queues[worker_index], true, task) ||
+      take_task_from(injection_queue, false, task)) {
+    return true;
+  }
+  const std::size_t queue_count = queues.size();
+  for (std::size_t offset = 1; offset < queue_count; ++offset) {
+    if (take_task_from(*queues[(worker_index + offset) % queue_count], false,
+                       task)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Work_stealing_pool::take_task_from(Task_queue& queue, bool is_newest,
+                                        std::function<void()>& task) {
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty()) return false;
+  if (is_newest) {
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+  } else {
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+  }
+  std::lock_guard<std::mutex> wake_lock(wake_mutex);
+  --queued_task_count;
+  return true;
+}
+
+void Work_stealing_pool::work(unsigned int worker_index) {
+  current_pool = this;
+  current_worker_index = worker_index;
+  std::function<void()> task;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex);
+      task_queued.wait(lock,
+                       [this] { return is_stopping || queued_task_count > 0; });
+      if (queued_task_count == 0) return;
+    }
+    // Another worker may take the counted task first, in which case the
+    // count has already dropped and the worker waits again
+    if (!take_task(worker_index, task)) continue;
+    try {
+      task();
+    } catch (...) {
+      // The task's error is its own; the worker carries on
+    }
+    task = nullptr;
+  }
+}
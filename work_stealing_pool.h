@@ -0,0 +1,100 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class Work_stealing_pool
+ *
+ * @brief A pool of worker threads running independent tasks, such as the
+ * searches of many games served by one Analysis_server.
+ *
+ * Every worker has its own queue for the tasks it submits itself, and tasks
+ * submitted from outside the pool share one injection queue. A worker runs
+ * the newest task of its own queue, else the oldest task of the injection
+ * queue, else steals the oldest task of another worker's queue. Outside
+ * submissions thus start in the order they were made, while the tasks a
+ * worker spawns run while their data is still warm, and no worker idles while
+ * others have a backlog.
+ * Unlike Thread_pool, which runs one task on all of its threads, each task
+ * runs on a single worker.
+ */
+class Work_stealing_pool {
+ public:
+  /**
+   * @brief Starts the workers of the pool.
+   *
+   * @param thread_count The number of workers. At least 1.
+   * @throws std::invalid_argument if thread_count is 0.
+   */
+  explicit Work_stealing_pool(unsigned int thread_count);
+
+  /**
+   * @brief Runs the remaining tasks, then stops and joins the workers.
+   */
+  ~Work_stealing_pool();
+
+  Work_stealing_pool(const Work_stealing_pool&) = delete;
+  Work_stealing_pool& operator=(const Work_stealing_pool&) = delete;
+
+  /**
+   * @brief Getter for the number of workers.
+   */
+  unsigned int get_thread_count() const;
+
+  /**
+   * @brief Queues a task to run on one of the workers.
+   *
+   * @param task The task. It should handle its own errors: an exception
+   * escaping a task is discarded so that the worker keeps running.
+   */
+  void submit(std::function<void()> task);
+
+ private:
+  struct Task_queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  std::vector<std::unique_ptr<Task_queue>> queues;
+  // The tasks submitted from outside the pool, served first in, first out
+  Task_queue injection_queue;
+  std::vector<std::thread> workers;
+  // Sleeping workers wait for queued tasks or the end of the pool
+  std::mutex wake_mutex;
+  std::condition_variable task_queued;
+  std::size_t queued_task_count = 0;
+  bool is_stopping = false;
+
+  /**
+   * @brief Takes the newest task of a worker's own queue, else the oldest
+   * task of the injection queue, else the oldest task of another worker's
+   * queue.
+   *
+   * @return True if a task was taken.
+   */
+  bool take_task(unsigned int worker_index, std::function<void()>& task);
+
+  /**
+   * @brief Takes the newest or the oldest task of a queue, if any, and
+   * uncounts it in the same critical section.
+   *
+   * @return True if a task was taken.
+   */
+  bool take_task_from(Task_queue& queue, bool is_newest,
+                      std::function<void()>& task);
+
+  /**
+   * @brief The loop of a worker, running tasks until the pool stops and no
+   * task is left.
+   */
+  void work(unsigned int worker_index);
+};
+
+#endif  // WORK_STEALING_POOL_H